@@ -20,6 +20,10 @@ std::string AstPrinter::visit(const Expression::Unary<std::string>& expr) const
     return parenthesize(expr.op().getLexeme(), {expr.right()});
 }
 
+std::string AstPrinter::visit(const Expression::Variable<std::string>& expr) const {
+    return std::string{expr.name().getLexeme()};
+}
+
 std::string AstPrinter::parenthesize(
     std::string_view name,
     std::initializer_list<std::reference_wrapper<const Expression::Expression<std::string>>> exprs)
@@ -25,6 +25,7 @@ class AstPrinter : public Expression::Visitor<std::string> {
     std::string visit(const Expression::Grouping<std::string>& expr) const override;
     std::string visit(const Expression::Literal<std::string>& expr) const override;
     std::string visit(const Expression::Unary<std::string>& expr) const override;
+    std::string visit(const Expression::Variable<std::string>& expr) const override;
 
   private:
     std::string parenthesize(
@@ -0,0 +1,135 @@
+#include "constantFolder.h"
+#include "typing/tokentypes.h"
+
+auto ConstantFolder::fold(const Expression::Expression<Value>& expr)
+    -> std::unique_ptr<Expression::Expression<Value>> {
+    return rebuild(expr);
+}
+
+Value ConstantFolder::visit(const Expression::Binary<Value>& expr) const {
+    auto left{rebuild(expr.left())};
+    auto right{rebuild(expr.right())};
+
+    const Value* leftValue{constant(*left)};
+    const Value* rightValue{constant(*right)};
+    if (leftValue != nullptr && rightValue != nullptr) {
+        if (auto value{binary(expr.op(), *leftValue, *rightValue)}) {
+            m_result = folded(std::move(*value));
+            return Value{};
+        }
+    }
+
+    m_result =
+        std::make_unique<Expression::Binary<Value>>(std::move(left), expr.op(), std::move(right));
+    return Value{};
+}
+
+Value ConstantFolder::visit(const Expression::Grouping<Value>& expr) const {
+    auto inner{rebuild(expr.expr())};
+
+    if (constant(*inner) != nullptr) {
+        // Parentheses around a literal carry no meaning, the literal itself is the result.
+        ++m_foldedNodes;
+        m_result = std::move(inner);
+        return Value{};
+    }
+
+    m_result = std::make_unique<Expression::Grouping<Value>>(std::move(inner));
+    return Value{};
+}
+
+Value ConstantFolder::visit(const Expression::Literal<Value>& expr) const {
+    m_result = std::make_unique<Expression::Literal<Value>>(expr.getLiteral());
+    return Value{};
+}
+
+Value ConstantFolder::visit(const Expression::Unary<Value>& expr) const {
+    auto right{rebuild(expr.right())};
+
+    if (const Value* rightValue{constant(*right)}) {
+        if (auto value{unary(expr.op(), *rightValue)}) {
+            m_result = folded(std::move(*value));
+            return Value{};
+        }
+    }
+
+    m_result = std::make_unique<Expression::Unary<Value>>(expr.op(), std::move(right));
+    return Value{};
+}
+
+Value ConstantFolder::visit(const Expression::Variable<Value>& expr) const {
+    // Only known once it is evaluated, and keeps everything above it from folding.
+    m_result = std::make_unique<Expression::Variable<Value>>(expr.name());
+    return Value{};
+}
+
+auto ConstantFolder::rebuild(const Expression::Expression<Value>& expr) const
+    -> std::unique_ptr<Expression::Expression<Value>> {
+    expr.accept(*this);
+    return std::move(m_result);
+}
+
+auto ConstantFolder::folded(Value value) const -> std::unique_ptr<Expression::Expression<Value>> {
+    ++m_foldedNodes;
+
+    if (value.isString()) {
+        // Concatenation builds ropes; the folded result is a literal like any other, so intern it.
+        value = Value::intern(value.asString());
+    }
+    return std::make_unique<Expression::Literal<Value>>(std::move(value));
+}
+
+auto ConstantFolder::constant(const Expression::Expression<Value>& expr) -> const Value* {
+    auto literal{dynamic_cast<const Expression::Literal<Value>*>(&expr)};
+    return literal != nullptr ? &literal->getLiteral() : nullptr;
+}
+
+/*
+ * Same semantics as Interpreter::visit(Binary), except that every case the interpreter would throw
+ * for returns nothing instead.
+ */
+auto ConstantFolder::binary(const Token& op, const Value& left, const Value& right)
+    -> std::optional<Value> {
+    bool numbers{left.isNumber() && right.isNumber()};
+
+    switch (op.getType()) {
+    case TokenType::_plus:
+        if (numbers) {
+            return left.asNumber() + right.asNumber();
+        } else if (left.isString() && right.isString()) {
+            return Value::concatenate(left, right);
+        }
+        return std::nullopt;
+    case TokenType::_minus:
+        return numbers ? std::optional<Value>{left.asNumber() - right.asNumber()} : std::nullopt;
+    case TokenType::_slash:
+        return numbers ? std::optional<Value>{left.asNumber() / right.asNumber()} : std::nullopt;
+    case TokenType::_star:
+        return numbers ? std::optional<Value>{left.asNumber() * right.asNumber()} : std::nullopt;
+    case TokenType::_greater:
+        return left > right;
+    case TokenType::_greater_equal:
+        return left >= right;
+    case TokenType::_less:
+        return left < right;
+    case TokenType::_less_equal:
+        return left <= right;
+    case TokenType::_equal_equal:
+        return left == right;
+    case TokenType::_bang_equal:
+        return left != right;
+    default:
+        return std::nullopt;
+    }
+}
+
+auto ConstantFolder::unary(const Token& op, const Value& right) -> std::optional<Value> {
+    switch (op.getType()) {
+    case TokenType::_minus:
+        return right.isNumber() ? std::optional<Value>{-right.asNumber()} : std::nullopt;
+    case TokenType::_bang:
+        return !right.isTruthy();
+    default:
+        return std::nullopt;
+    }
+}
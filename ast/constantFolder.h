@@ -0,0 +1,55 @@
+#ifndef CONSTANT_FOLDER_H
+#define CONSTANT_FOLDER_H
+
+#include "expressionTrees.h"
+#include "typing/token.h"
+#include "typing/value.h"
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+/*
+ * Optimization pass that rebuilds an expression tree with every literal-only Binary, Unary and
+ * Grouping node replaced by a single Literal. Operations that would raise a runtime error (e.g.
+ * `-"a"`) are left in the tree so the error still happens, with its line, when it is evaluated.
+ *
+ * The visitor interface has to return the tree's result type, so visits return nothing useful
+ * and leave the rebuilt subtree in m_result instead.
+ */
+class ConstantFolder : public Expression::Visitor<Value> {
+  public:
+    ConstantFolder() = default;
+
+    ConstantFolder(const ConstantFolder&) = delete;
+    ConstantFolder& operator=(const ConstantFolder&) = delete;
+
+    ConstantFolder(ConstantFolder&&) noexcept = delete;
+    ConstantFolder& operator=(ConstantFolder&&) = delete;
+
+    std::unique_ptr<Expression::Expression<Value>> fold(const Expression::Expression<Value>& expr);
+
+    // Nodes folded away over every fold() call so far.
+    std::size_t foldedNodes() const {
+        return m_foldedNodes;
+    }
+
+    Value visit(const Expression::Binary<Value>& expr) const override;
+    Value visit(const Expression::Grouping<Value>& expr) const override;
+    Value visit(const Expression::Literal<Value>& expr) const override;
+    Value visit(const Expression::Unary<Value>& expr) const override;
+    Value visit(const Expression::Variable<Value>& expr) const override;
+
+  private:
+    std::unique_ptr<Expression::Expression<Value>>
+    rebuild(const Expression::Expression<Value>& expr) const;
+    std::unique_ptr<Expression::Expression<Value>> folded(Value value) const;
+
+    static const Value* constant(const Expression::Expression<Value>& expr);
+    static std::optional<Value> binary(const Token& op, const Value& left, const Value& right);
+    static std::optional<Value> unary(const Token& op, const Value& right);
+
+    mutable std::unique_ptr<Expression::Expression<Value>> m_result;
+    mutable std::size_t m_foldedNodes{0};
+};
+
+#endif // CONSTANT_FOLDER_H
@@ -93,7 +93,7 @@ class Grouping final : public Expression<R> {
 template <typename R>
 class Literal final : public Expression<R> {
   public:
-    Literal(Type literal) : m_literal{literal} {}
+    Literal(Value literal) : m_literal{std::move(literal)} {}
 
     Literal(const Literal&) = delete;
     Literal& operator=(const Literal&) = delete;
@@ -105,12 +105,12 @@ class Literal final : public Expression<R> {
         return visitor.visit(*this);
     };
 
-    Type getLiteral() const {
+    const Value& getLiteral() const {
         return m_literal;
     }
 
   private:
-    Type m_literal;
+    Value m_literal;
 };
 
 template <typename R>
@@ -142,6 +142,30 @@ class Unary : public Expression<R> {
     Token m_operator;
 };
 
+// A name, bound to a value by whoever evaluates the tree (see lox::compile).
+template <typename R>
+class Variable final : public Expression<R> {
+  public:
+    Variable(Token name) : m_name{name} {}
+
+    Variable(const Variable&) = delete;
+    Variable& operator=(const Variable&) = delete;
+
+    Variable(Variable&&) noexcept = delete;
+    Variable& operator=(Variable&&) = delete;
+
+    R accept(const Visitor<R>& visitor) const override {
+        return visitor.visit(*this);
+    };
+
+    const Token& name() const {
+        return m_name;
+    }
+
+  private:
+    Token m_name;
+};
+
 /*
  * Use the visitor pattern to minimize code changes in the syntax trees themselves. Separates the
  * algorithm (here) from the class types (trees.h)
@@ -163,6 +187,7 @@ class Visitor {
     virtual R visit(const Grouping<R>& expr) const = 0;
     virtual R visit(const Literal<R>& expr) const = 0;
     virtual R visit(const Unary<R>& expr) const = 0;
+    virtual R visit(const Variable<R>& expr) const = 0;
 };
 
 } // namespace Expression
@@ -0,0 +1,94 @@
+#ifndef FLAT_AST_H
+#define FLAT_AST_H
+
+#include "typing/tokentypes.h"
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/*
+ * Index-based alternative to the pointer trees in expressionTrees.h. Every node lives in one
+ * contiguous arena owned by the Ast, children are 32-bit indices into that arena and tokens are
+ * indices into the token stream the tree was parsed from. The whole tree is freed in one go.
+ */
+namespace Flat {
+
+using NodeIndex = std::uint32_t;
+using TokenIndex = std::uint32_t;
+
+// Returned by the parser in place of a node once it has hit an error.
+inline constexpr NodeIndex NO_NODE{std::numeric_limits<NodeIndex>::max()};
+
+enum class NodeKind : std::uint8_t {
+    _binary,
+    _grouping,
+    _literal,
+    _unary,
+    _variable,
+};
+
+/*
+ * One node of any kind, 16 bytes.
+ *  - Binary:   lhs, rhs are the operands, token is the operator.
+ *  - Grouping: lhs is the inner expression.
+ *  - Literal:  token is the literal (or true/false/nil keyword).
+ *  - Unary:    lhs is the operand, token is the operator.
+ *  - Variable: token is the name.
+ * The operator type is duplicated inline so evaluation does not have to touch the token.
+ */
+struct Node {
+    NodeKind kind;
+    TokenType op;
+    NodeIndex lhs;
+    NodeIndex rhs;
+    TokenIndex token;
+};
+
+static_assert(sizeof(Node) == 16, "Flat::Node should stay cache friendly.");
+
+class Ast {
+  public:
+    Ast() = default;
+
+    Ast(const Ast&) = delete;
+    Ast& operator=(const Ast&) = delete;
+
+    Ast(Ast&&) noexcept = default;
+    Ast& operator=(Ast&&) = default;
+
+    ~Ast() = default;
+
+    void reserve(std::size_t nodes) {
+        m_nodes.reserve(nodes);
+    }
+
+    NodeIndex add(Node node) {
+        m_nodes.push_back(node);
+        return static_cast<NodeIndex>(m_nodes.size() - 1);
+    }
+
+    const Node& operator[](NodeIndex index) const {
+        assert(index < m_nodes.size() && "Out of bounds access.");
+        return m_nodes[index];
+    }
+
+    std::size_t size() const {
+        return m_nodes.size();
+    }
+
+    NodeIndex root() const {
+        return m_root;
+    }
+    void setRoot(NodeIndex root) {
+        m_root = root;
+    }
+
+  private:
+    std::vector<Node> m_nodes;
+    NodeIndex m_root{0};
+};
+
+} // namespace Flat
+
+#endif // FLAT_AST_H
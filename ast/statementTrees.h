@@ -2,6 +2,8 @@
 #define STATEMENT_TREES
 
 #include "expressionTrees.h"
+#include <memory>
+#include <vector>
 
 namespace Statement {
 
@@ -41,6 +43,10 @@ class PrintStatement : public Statement<R> {
         return visitor.visit(*this);
     };
 
+    const Expression::Expression<R>& expr() const {
+        return *m_expr;
+    }
+
   private:
     std::unique_ptr<Expression::Expression<R>> m_expr;
 };
@@ -60,10 +66,18 @@ class ExpressionStatement : public Statement<R> {
         return visitor.visit(*this);
     };
 
+    const Expression::Expression<R>& expr() const {
+        return *m_expr;
+    }
+
   private:
     std::unique_ptr<Expression::Expression<R>> m_expr;
 };
 
+// program -> statement* EOF, in source order.
+template <typename R>
+using Program = std::vector<std::unique_ptr<Statement<R>>>;
+
 /*
  * Use the visitor pattern to minimize code changes in the syntax trees themselves. Separates the
  * algorithm (here) from the class types (trees.h)
@@ -0,0 +1,182 @@
+#include "generator.h"
+#include <string_view>
+#include <vector>
+
+namespace Bench {
+namespace {
+
+// splitmix64, small and fully specified.
+class Random {
+  public:
+    explicit Random(std::uint64_t seed) : m_state{seed} {}
+
+    std::uint64_t next() {
+        std::uint64_t z{m_state += 0x9e3779b97f4a7c15};
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, bound).
+    std::size_t below(std::size_t bound) {
+        return static_cast<std::size_t>(next() % bound);
+    }
+
+    bool chance(double probability) {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53 < probability;
+    }
+
+  private:
+    std::uint64_t m_state;
+};
+
+class Generator {
+  public:
+    Generator(const CorpusConfig& config) : m_config{config}, m_random{config.seed} {}
+
+    std::string run() {
+        std::vector<std::string> units{};
+        std::size_t bytes{0};
+
+        do {
+            std::string unit{this->unit()};
+            bytes += unit.size();
+            units.push_back(std::move(unit));
+        } while (bytes < m_config.bytes);
+
+        std::string out{};
+        out.reserve(bytes + bytes / 4);
+        combine(out, units, 0, units.size());
+        out += '\n';
+        return out;
+    }
+
+    std::string program() {
+        std::string out{};
+        do {
+            if (m_random.chance(0.5)) {
+                out += "print ";
+            }
+            out += unit();
+            out += ";\n";
+        } while (out.size() < m_config.bytes);
+        return out;
+    }
+
+  private:
+    std::string unit() {
+        std::string unit{};
+        if (m_random.chance(m_config.strings)) {
+            string(unit, m_config.depth);
+        } else {
+            number(unit, m_config.depth);
+        }
+        return unit;
+    }
+
+    // Equality and comparison never raise, whatever the operand types.
+    void combine(std::string& out, const std::vector<std::string>& units, std::size_t begin,
+                 std::size_t end) {
+        if (end - begin == 1) {
+            out += units[begin];
+            return;
+        }
+
+        static constexpr std::string_view operators[]{" == ", " != ", " < ", " >= "};
+        std::size_t middle{begin + (end - begin) / 2};
+
+        out += '(';
+        combine(out, units, begin, middle);
+        token(out, operators[m_random.below(std::size(operators))]);
+        if (m_random.chance(0.1)) {
+            out += '\n';
+        }
+        combine(out, units, middle, end);
+        token(out, ")");
+    }
+
+    void number(std::string& out, int depth) {
+        if (depth == 0 || m_random.chance(0.3)) {
+            std::string literal{std::to_string(m_random.below(100000))};
+            if (m_random.chance(0.3)) {
+                literal += '.';
+                literal += std::to_string(m_random.below(1000));
+            }
+            token(out, literal);
+            return;
+        }
+
+        switch (m_random.below(4)) {
+        case 0:
+            token(out, "-");
+            number(out, depth - 1);
+            break;
+        case 1:
+            token(out, "(");
+            number(out, depth - 1);
+            token(out, ")");
+            break;
+        default: {
+            static constexpr std::string_view operators[]{" + ", " - ", " * ", " / "};
+            number(out, depth - 1);
+            token(out, operators[m_random.below(std::size(operators))]);
+            number(out, depth - 1);
+            break;
+        }
+        }
+    }
+
+    void string(std::string& out, int depth) {
+        if (depth == 0 || m_random.chance(0.3)) {
+            static constexpr std::string_view words[]{"lorem", "ipsum", "dolor", "sit",
+                                                      "amet",  "lox",   "tree",  "token"};
+            out += '"';
+            for (std::size_t i{0}, n{1 + m_random.below(4)}; i < n; ++i) {
+                out += words[m_random.below(std::size(words))];
+                out += ' ';
+            }
+            token(out, "\"");
+            return;
+        }
+
+        if (m_random.chance(0.2)) {
+            token(out, "(");
+            string(out, depth - 1);
+            token(out, ")");
+            return;
+        }
+
+        string(out, depth - 1);
+        token(out, " + ");
+        string(out, depth - 1);
+    }
+
+    // Appends a token, maybe followed by a comment.
+    void token(std::string& out, std::string_view text) {
+        out += text;
+
+        if (!m_random.chance(m_config.comments)) {
+            return;
+        }
+        if (m_random.chance(0.5)) {
+            out += " // generated line comment\n";
+        } else {
+            out += " /* generated\n block comment */ ";
+        }
+    }
+
+    const CorpusConfig& m_config;
+    Random m_random;
+};
+
+} // namespace
+
+std::string generate(const CorpusConfig& config) {
+    return Generator{config}.run();
+}
+
+std::string generateProgram(const CorpusConfig& config) {
+    return Generator{config}.program();
+}
+
+} // namespace Bench
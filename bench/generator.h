@@ -0,0 +1,38 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Bench {
+
+struct CorpusConfig {
+    std::size_t bytes{1 << 20}; // approximate size of the generated script
+    int depth{4};               // maximum nesting of each generated subexpression
+    double strings{0.2};        // share of subexpressions that are string concatenations
+    double comments{0.05};      // chance of a comment after any token
+    std::uint64_t seed{42};
+
+    bool operator==(const CorpusConfig&) const = default;
+};
+
+/*
+ * Emits one valid Lox expression that evaluates without runtime errors. Number and string
+ * subexpressions are only ever mixed through equality operators, and they are combined as a
+ * balanced tree so the nesting stays logarithmic in the size of the script.
+ *
+ * The output only depends on the config: the generator uses its own PRNG rather than the standard
+ * distributions, whose results differ between standard libraries.
+ */
+std::string generate(const CorpusConfig& config);
+
+/*
+ * Emits a program of flat statements, one per line: the same subexpressions generate() combines,
+ * each its own statement and every other one or so printed.
+ */
+std::string generateProgram(const CorpusConfig& config);
+
+} // namespace Bench
+
+#endif // GENERATOR_H
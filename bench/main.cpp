@@ -0,0 +1,552 @@
+#include "embed/preparedExpr.h"
+#include "generator.h"
+#include "interpreter/closureInterpreter.h"
+#include "interpreter/columnInterpreter.h"
+#include "interpreter/flatInterpreter.h"
+#include "interpreter/interpreter.h"
+#include "jit/jitCompiler.h"
+#include "lexer/lexer.h"
+#include "lexer/parallelLexer.h"
+#include "memory/allocationStats.h"
+#include "parser/flatParser.h"
+#include "parser/parallelParser.h"
+#include "parser/parser.h"
+#include "vm/compiler.h"
+#include "vm/vm.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/*
+ * Throughput benchmarks for each stage of the pipeline over a generated corpus, printed as JSON so
+ * runs can be diffed against a stored baseline. Each benchmark reports its best iteration.
+ *
+ * The error_* benchmarks run scripts that fail at the bottom of a deeply nested expression, the
+ * worst case for error propagation. The prepared_* benchmarks evaluate one rule expression
+ * through the embedding API against a table of records, on one thread and on all of them.
+ * eval_column runs the numeric part of that rule over whole columns with the ColumnInterpreter,
+ * eval_column_c is the same computation as a hand-written loop, for reference. jit_eval runs it
+ * compiled to native code, one record at a time like prepared_eval. The alloc_* results only
+ * appear in builds that count allocations, see ALLOCATION_BUDGETS; --budgets checks those and
+ * nothing else.
+ *
+ * lex_parallel lexes the corpus in one chunk per hardware thread. The parse_program benchmarks
+ * parse the same subexpressions as a program of flat statements, parse_parallel in one slice per
+ * hardware thread. Both parallel versions are first checked against the sequential ones, split
+ * into CHECK_CHUNKS.
+ */
+
+namespace {
+
+struct Result {
+    std::string_view name;
+    std::string_view unit;
+    double value;
+    double seconds;
+};
+
+// Scripts per iteration of the error benchmarks, and how deep they fail.
+constexpr int ERROR_SCRIPTS{1000};
+constexpr int ERROR_DEPTH{32};
+
+// (1 + (1 + ... innermost ... ))
+std::string nested(std::string_view innermost) {
+    std::string script{};
+    for (int i{0}; i < ERROR_DEPTH; ++i) {
+        script += "(1 + ";
+    }
+    script += innermost;
+    script.append(ERROR_DEPTH, ')');
+    return script;
+}
+
+// Records per iteration of the prepared benchmarks, and the rule evaluated against each.
+constexpr std::size_t PREPARED_RECORDS{100000};
+constexpr std::string_view PREPARED_RULE{
+    "(price * quantity - discount) / quantity >= limit == (region == \"eu\")"};
+constexpr std::array<std::string_view, 5> PREPARED_INPUTS{"price", "quantity", "discount",
+                                                          "limit", "region"};
+
+// The numeric part of the rule, over columns of PREPARED_RECORDS rows.
+constexpr std::string_view COLUMN_RULE{"(price * quantity - discount) / quantity >= limit"};
+
+// PREPARED_RECORDS rows of PREPARED_INPUTS values, back to back.
+std::vector<Value> preparedRecords() {
+    Value regions[]{Value::intern("eu"), Value::intern("us"), Value::intern("apac")};
+
+    std::vector<Value> records{};
+    records.reserve(PREPARED_RECORDS * PREPARED_INPUTS.size());
+    for (std::size_t i{0}; i < PREPARED_RECORDS; ++i) {
+        records.emplace_back(static_cast<double>(1 + i % 97));
+        records.emplace_back(static_cast<double>(1 + i % 13));
+        records.emplace_back(static_cast<double>(i % 7));
+        records.emplace_back(50.0);
+        records.push_back(regions[i % std::size(regions)]);
+    }
+    return records;
+}
+
+// Evaluates the rule once per record, false if any evaluation fails.
+bool evaluateRecords(const lox::PreparedExpr& rule, const std::vector<Value>& records) {
+    bool ok{true};
+    for (std::size_t i{0}; i < records.size(); i += PREPARED_INPUTS.size()) {
+        auto result{rule.evaluate(std::span{records}.subspan(i, PREPARED_INPUTS.size()))};
+        ok = ok && result.has_value() && result->isBoolean();
+    }
+    return ok;
+}
+
+/*
+ * Most heap allocations allowed per thousand tokens (lex) or nodes (everything else). Measured in
+ * builds configured with -DLOX_ALLOC_STATS=ON, where going over a budget on the default corpus
+ * fails the run, so a change that starts allocating in a hot path cannot go unnoticed.
+ */
+struct AllocationBudget {
+    std::string_view name;
+    std::string_view unit;
+    double limit;
+};
+
+// Tokens live in a few growing arrays, a pointer tree allocates each node on its own, a flat one
+// all of them at once, and evaluation allocates for strings only.
+constexpr std::array<AllocationBudget, 5> ALLOCATION_BUDGETS{{
+    {"alloc_lex", "allocs/ktoken", 10},
+    {"alloc_parse_tree", "allocs/knode", 1050},
+    {"alloc_parse_flat", "allocs/knode", 10},
+    {"alloc_eval_tree", "allocs/knode", 250},
+    {"alloc_eval_closure", "allocs/knode", 250},
+}};
+
+// Chunks the parallel lexer and parser are checked with, whatever the core count.
+constexpr std::size_t CHECK_CHUNKS{8};
+
+// Token for token, literals and lines included.
+bool sameTokens(const TokenList& expected, const TokenList& actual) {
+    if (expected.size() != actual.size()) {
+        return false;
+    }
+    for (TokenList::Index i{0}; i < expected.size(); ++i) {
+        std::string_view lexeme{expected.lexeme(i)};
+        if (expected.type(i) != actual.type(i) || lexeme.data() != actual.lexeme(i).data() ||
+            lexeme.size() != actual.lexeme(i).size() || expected.literal(i) != actual.literal(i) ||
+            expected.line(i) != actual.line(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// What running a program prints, one line per print statement.
+std::string programOutput(const Statement::Program<Value>& program) {
+    std::ostringstream out{};
+    Interpreter{out, out}.interpret(program);
+    return std::move(out).str();
+}
+
+// Heap allocations made by one run of `body`.
+double allocations(const std::function<void()>& body) {
+    AllocationStats::reset();
+    {
+        AllocationStats::Scope scope{Phase::_other};
+        body();
+    }
+    return static_cast<double>(AllocationStats::counters(Phase::_other).allocations);
+}
+
+// Best time of `iterations` runs, after one warm-up run.
+double bestSeconds(int iterations, const std::function<void()>& body) {
+    body();
+
+    double best{std::numeric_limits<double>::max()};
+    for (int i{0}; i < iterations; ++i) {
+        auto start{std::chrono::steady_clock::now()};
+        body();
+        std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+template <typename T>
+bool parseOption(std::string_view arg, std::string_view name, T& value) {
+    if (!arg.starts_with(name) || arg.size() == name.size() || arg[name.size()] != '=') {
+        return false;
+    }
+
+    std::string_view text{arg.substr(name.size() + 1)};
+    auto result{std::from_chars(text.data(), text.data() + text.size(), value)};
+    if (result.ec != std::errc{} || result.ptr != text.data() + text.size()) {
+        std::println(std::cerr, "Invalid value for {}: {}", name, text);
+        std::exit(EXIT_FAILURE);
+    }
+    return true;
+}
+
+void usage() {
+    std::println(std::cerr, "Usage: lox_bench [--bytes=N] [--depth=N] [--strings=R] "
+                            "[--comments=R] [--seed=N] [--iterations=N] [--dump] [--budgets]");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Bench::CorpusConfig config{};
+    int iterations{5};
+    bool dump{false};
+    bool budgetsOnly{false};
+
+    for (int i{1}; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+
+        if (arg == "--dump") {
+            dump = true;
+        } else if (arg == "--budgets") {
+            budgetsOnly = true;
+        } else if (!(parseOption(arg, "--bytes", config.bytes) ||
+                     parseOption(arg, "--depth", config.depth) ||
+                     parseOption(arg, "--strings", config.strings) ||
+                     parseOption(arg, "--comments", config.comments) ||
+                     parseOption(arg, "--seed", config.seed) ||
+                     parseOption(arg, "--iterations", iterations))) {
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::string source{Bench::generate(config)};
+    if (dump) {
+        // Lets the corpus be fed to the interpreter itself.
+        std::cout << source;
+        return EXIT_SUCCESS;
+    }
+
+    // Diagnostics would only mean the generator is broken, keep them out of the JSON. A stream
+    // without a buffer drops everything written to it.
+    std::ostream discard{nullptr};
+
+    Lexer lexer{source, discard, discard};
+    TokenList tokens{lexer.lexTokens()};
+    FlatParser flatParser{tokens, discard, discard};
+    auto flatAst{flatParser.parse()};
+    auto tree{Parser<Value>{tokens, discard, discard}.parse()};
+
+    if (lexer.hadError() || !flatAst.has_value() || tree == nullptr) {
+        std::println(std::cerr, "Generated corpus does not parse.");
+        return EXIT_FAILURE;
+    }
+
+    double nodes{static_cast<double>(flatAst->size())};
+    double megabytes{static_cast<double>(source.size()) / (1024.0 * 1024.0)};
+    std::vector<Result> results{};
+    bool ok{true};
+
+    if (AllocationStats::enabled()) {
+        double kilotokens{static_cast<double>(tokens.size()) / 1000.0};
+        double kilonodes{nodes / 1000.0};
+        std::array<double, ALLOCATION_BUDGETS.size()> measured{
+            allocations([&] { Lexer{source, discard, discard}.lexTokens(); }) / kilotokens,
+            allocations([&] { Parser<Value>{tokens, discard, discard}.parse(); }) / kilonodes,
+            allocations([&] { FlatParser{tokens, discard, discard}.parse(); }) / kilonodes,
+            allocations([&] { Interpreter{discard, discard}.evaluate(*tree); }) / kilonodes,
+            allocations([&] {
+                ClosureInterpreter{discard, discard}.evaluate(ClosureInterpreter::compile(*tree));
+            }) / kilonodes,
+        };
+
+        for (std::size_t i{0}; i < measured.size(); ++i) {
+            const auto& budget{ALLOCATION_BUDGETS[i]};
+            results.push_back({budget.name, budget.unit, measured[i], 0.0});
+            if (config == Bench::CorpusConfig{} && measured[i] > budget.limit) {
+                std::println(std::cerr, "{} is {:.1f} {}, over its budget of {}.", budget.name,
+                             measured[i], budget.unit, budget.limit);
+                ok = false;
+            }
+        }
+        if (!ok) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (budgetsOnly) {
+        // Run by ctest, which must not pass without having checked anything.
+        if (!AllocationStats::enabled()) {
+            std::println(std::cerr, "Allocation budgets need a build configured with "
+                                    "-DLOX_ALLOC_STATS=ON.");
+            return EXIT_FAILURE;
+        }
+        for (const Result& result : results) {
+            std::println("{}: {:.1f} {}", result.name, result.value, result.unit);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    double seconds{bestSeconds(iterations, [&] { Lexer{source, discard, discard}.lexTokens(); })};
+    results.push_back({"lex", "MB/s", megabytes / seconds, seconds});
+
+    ParallelLexer splitLexer{source, CHECK_CHUNKS, discard, discard, 1};
+    if (!sameTokens(tokens, splitLexer.lexTokens()) || splitLexer.hadError()) {
+        std::println(std::cerr, "Parallel lexer does not match the lexer.");
+        return EXIT_FAILURE;
+    }
+
+    std::size_t threads{std::max(1u, std::thread::hardware_concurrency())};
+    seconds = bestSeconds(iterations, [&] {
+        ParallelLexer{source, threads, discard, discard, source.size() / threads}.lexTokens();
+    });
+    results.push_back({"lex_parallel", "MB/s", megabytes / seconds, seconds});
+
+    seconds = bestSeconds(iterations, [&] { Parser<Value>{tokens, discard, discard}.parse(); });
+    results.push_back({"parse_tree", "nodes/s", nodes / seconds, seconds});
+
+    seconds = bestSeconds(iterations, [&] { FlatParser{tokens, discard, discard}.parse(); });
+    results.push_back({"parse_flat", "nodes/s", nodes / seconds, seconds});
+
+    std::string programSource{Bench::generateProgram(config)};
+    TokenList programTokens{Lexer{programSource, discard, discard}.lexTokens()};
+    auto parsedProgram{Parser<Value>{programTokens, discard, discard}.parseProgram()};
+    auto splitProgram{
+        ParallelParser<Value>{programTokens, CHECK_CHUNKS, discard, discard, 1}.parseProgram()};
+    if (!parsedProgram.has_value() || !splitProgram.has_value() ||
+        programOutput(*parsedProgram) != programOutput(*splitProgram)) {
+        std::println(std::cerr, "Parallel parser does not match the parser.");
+        return EXIT_FAILURE;
+    }
+    double statements{static_cast<double>(parsedProgram->size())};
+
+    seconds = bestSeconds(iterations, [&] {
+        Parser<Value>{programTokens, discard, discard}.parseProgram();
+    });
+    results.push_back({"parse_program", "statements/s", statements / seconds, seconds});
+
+    seconds = bestSeconds(iterations, [&] {
+        ParallelParser<Value>{programTokens, threads, discard, discard,
+                              programTokens.size() / threads}
+            .parseProgram();
+    });
+    results.push_back({"parse_parallel", "statements/s", statements / seconds, seconds});
+
+    Interpreter interpreter{discard, discard};
+    seconds = bestSeconds(iterations, [&] { ok = ok && interpreter.evaluate(*tree).isBoolean(); });
+    results.push_back({"eval_tree", "nodes/s", nodes / seconds, seconds});
+
+    FlatInterpreter flatInterpreter{discard, discard};
+    seconds = bestSeconds(iterations, [&] {
+        ok = ok && flatInterpreter.evaluate(*flatAst, tokens, flatAst->root()).isBoolean();
+    });
+    results.push_back({"eval_flat", "nodes/s", nodes / seconds, seconds});
+
+    Chunk chunk{};
+    Compiler{chunk}.compile(*tree);
+    VM vm{discard, discard};
+    seconds = bestSeconds(iterations, [&] { ok = ok && vm.run(chunk).isBoolean(); });
+    results.push_back({"eval_vm", "nodes/s", nodes / seconds, seconds});
+
+    auto program{ClosureInterpreter::compile(*tree)};
+    ClosureInterpreter closureInterpreter{discard, discard};
+    seconds = bestSeconds(iterations,
+                          [&] { ok = ok && closureInterpreter.evaluate(program).isBoolean(); });
+    results.push_back({"eval_closure", "nodes/s", nodes / seconds, seconds});
+
+    if (!ok) {
+        std::println(std::cerr, "Generated corpus did not evaluate to a boolean.");
+        return EXIT_FAILURE;
+    }
+
+    // Each runs ERROR_SCRIPTS failing scripts per iteration, on fresh parsers but reusing the
+    // evaluators like a batch session would.
+    std::string parseFailure{nested("")};
+    TokenList parseFailureTokens{Lexer{parseFailure, discard, discard}.lexTokens()};
+    seconds = bestSeconds(iterations, [&] {
+        for (int i{0}; i < ERROR_SCRIPTS; ++i) {
+            Parser<Value> parser{parseFailureTokens, discard, discard};
+            ok = ok && parser.parse() == nullptr && parser.hadError();
+        }
+    });
+    results.push_back({"error_parse", "scripts/s", ERROR_SCRIPTS / seconds, seconds});
+
+    std::string runtimeFailure{nested("-\"x\"")};
+    TokenList runtimeFailureTokens{Lexer{runtimeFailure, discard, discard}.lexTokens()};
+    auto failingTree{Parser<Value>{runtimeFailureTokens, discard, discard}.parse()};
+    auto failingFlatAst{FlatParser{runtimeFailureTokens, discard, discard}.parse()};
+    Chunk failingChunk{};
+    Compiler{failingChunk}.compile(*failingTree);
+    auto failingProgram{ClosureInterpreter::compile(*failingTree)};
+
+    seconds = bestSeconds(iterations, [&] {
+        for (int i{0}; i < ERROR_SCRIPTS; ++i) {
+            interpreter.interpret(*failingTree);
+        }
+    });
+    results.push_back({"error_eval_tree", "scripts/s", ERROR_SCRIPTS / seconds, seconds});
+
+    seconds = bestSeconds(iterations, [&] {
+        for (int i{0}; i < ERROR_SCRIPTS; ++i) {
+            flatInterpreter.interpret(*failingFlatAst, runtimeFailureTokens);
+        }
+    });
+    results.push_back({"error_eval_flat", "scripts/s", ERROR_SCRIPTS / seconds, seconds});
+
+    seconds = bestSeconds(iterations, [&] {
+        for (int i{0}; i < ERROR_SCRIPTS; ++i) {
+            vm.interpret(failingChunk);
+        }
+    });
+    results.push_back({"error_eval_vm", "scripts/s", ERROR_SCRIPTS / seconds, seconds});
+
+    seconds = bestSeconds(iterations, [&] {
+        for (int i{0}; i < ERROR_SCRIPTS; ++i) {
+            closureInterpreter.interpret(failingProgram);
+        }
+    });
+    results.push_back({"error_eval_closure", "scripts/s", ERROR_SCRIPTS / seconds, seconds});
+
+    if (!ok || !interpreter.hadRuntimeError() || !flatInterpreter.hadRuntimeError() ||
+        !vm.hadRuntimeError() || !closureInterpreter.hadRuntimeError()) {
+        std::println(std::cerr, "Error benchmarks did not fail as expected.");
+        return EXIT_FAILURE;
+    }
+
+    // What every evaluation cost before prepared expressions: lexing, parsing and compiling.
+    seconds = bestSeconds(iterations, [&] {
+        for (int i{0}; i < ERROR_SCRIPTS; ++i) {
+            ok = ok && lox::compile(PREPARED_RULE, PREPARED_INPUTS, discard).has_value();
+        }
+    });
+    results.push_back({"prepared_compile", "compiles/s", ERROR_SCRIPTS / seconds, seconds});
+
+    auto rule{lox::compile(PREPARED_RULE, PREPARED_INPUTS, discard)};
+    if (!ok || !rule.has_value()) {
+        std::println(std::cerr, "Prepared rule does not compile.");
+        return EXIT_FAILURE;
+    }
+    std::vector<Value> records{preparedRecords()};
+
+    seconds = bestSeconds(iterations, [&] { ok = ok && evaluateRecords(*rule, records); });
+    results.push_back({"prepared_eval", "evals/s", PREPARED_RECORDS / seconds, seconds});
+
+    // Every thread evaluates the whole table against the one shared handle.
+    std::atomic<bool> threadsOk{true};
+    seconds = bestSeconds(iterations, [&] {
+        std::vector<std::jthread> pool{};
+        pool.reserve(threads);
+        for (std::size_t i{0}; i < threads; ++i) {
+            pool.emplace_back([&] {
+                if (!evaluateRecords(*rule, records)) {
+                    threadsOk = false;
+                }
+            });
+        }
+    });
+    results.push_back({"prepared_eval_mt", "evals/s",
+                       static_cast<double>(PREPARED_RECORDS * threads) / seconds, seconds});
+
+    if (!ok || !threadsOk) {
+        std::println(std::cerr, "Prepared rule did not evaluate to a boolean.");
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::vector<double>> columns(4, std::vector<double>(PREPARED_RECORDS));
+    for (std::size_t row{0}; row < PREPARED_RECORDS; ++row) {
+        for (std::size_t input{0}; input < columns.size(); ++input) {
+            columns[input][row] = records[row * PREPARED_INPUTS.size() + input].asNumber();
+        }
+    }
+    std::array<ColumnInterpreter::Column, 4> bound{};
+    for (std::size_t input{0}; input < bound.size(); ++input) {
+        bound[input] = {PREPARED_INPUTS[input], columns[input], {}};
+    }
+
+    Lexer columnLexer{COLUMN_RULE, discard, discard};
+    TokenList columnTokens{columnLexer.lexTokens()};
+    auto columnTree{Parser<Value>{columnTokens, discard, discard}.parse()};
+    std::vector<ColumnInterpreter::Kind> kinds(PREPARED_RECORDS);
+    std::vector<double> values(PREPARED_RECORDS);
+    ColumnInterpreter columnInterpreter{};
+
+    seconds = bestSeconds(iterations, [&] {
+        ok = ok && columnInterpreter.evaluate(*columnTree, bound, kinds, values);
+    });
+    results.push_back({"eval_column", "rows/s", PREPARED_RECORDS / seconds, seconds});
+
+    std::vector<double> expected(PREPARED_RECORDS);
+    seconds = bestSeconds(iterations, [&] {
+        const double* price{columns[0].data()};
+        const double* quantity{columns[1].data()};
+        const double* discount{columns[2].data()};
+        const double* limit{columns[3].data()};
+        for (std::size_t row{0}; row < PREPARED_RECORDS; ++row) {
+            expected[row] =
+                (price[row] * quantity[row] - discount[row]) / quantity[row] >= limit[row];
+        }
+    });
+    results.push_back({"eval_column_c", "rows/s", PREPARED_RECORDS / seconds, seconds});
+
+    ok = ok && std::all_of(kinds.begin(), kinds.end(), [](ColumnInterpreter::Kind kind) {
+        return kind == ColumnInterpreter::Kind::_boolean;
+    });
+    if (!ok || values != expected) {
+        std::println(std::cerr, "Column evaluation does not match the reference loop.");
+        return EXIT_FAILURE;
+    }
+
+    std::span<const std::string_view> numericInputs{PREPARED_INPUTS.data(), columns.size()};
+    seconds = bestSeconds(iterations, [&] {
+        for (int i{0}; i < ERROR_SCRIPTS; ++i) {
+            ok = ok && Jit::Compiler{numericInputs}.compile(*columnTree).has_value();
+        }
+    });
+    results.push_back({"jit_compile", "compiles/s", ERROR_SCRIPTS / seconds, seconds});
+
+    auto native{Jit::Compiler{numericInputs}.compile(*columnTree)};
+    if (!ok || !native.has_value()) {
+        std::println(std::cerr, "Column rule does not compile to native code.");
+        return EXIT_FAILURE;
+    }
+
+    std::vector<double> nativeValues(PREPARED_RECORDS);
+    seconds = bestSeconds(iterations, [&] {
+        for (std::size_t row{0}; row < PREPARED_RECORDS; ++row) {
+            auto record{std::span{records}.subspan(row * PREPARED_INPUTS.size(), columns.size())};
+            auto result{native->evaluate(record)};
+            ok = ok && result.has_value();
+            nativeValues[row] = result.has_value() && result->isTruthy();
+        }
+    });
+    results.push_back({"jit_eval", "evals/s", PREPARED_RECORDS / seconds, seconds});
+
+    if (!ok || nativeValues != expected) {
+        std::println(std::cerr, "Native code does not match the reference loop.");
+        return EXIT_FAILURE;
+    }
+
+    std::println("{{");
+    std::println("  \"config\": {{\"bytes\": {}, \"depth\": {}, \"strings\": {}, \"comments\": {}, "
+                 "\"seed\": {}, \"iterations\": {}}},",
+                 source.size(), config.depth, config.strings, config.comments, config.seed,
+                 iterations);
+    std::println("  \"nodes\": {},", flatAst->size());
+    std::println("  \"results\": [");
+    for (std::size_t i{0}; i < results.size(); ++i) {
+        const auto& result{results[i]};
+        std::println("    {{\"name\": \"{}\", \"unit\": \"{}\", \"value\": {:.1f}, "
+                     "\"seconds\": {:.6f}}}{}",
+                     result.name, result.unit, result.value, result.seconds,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::println("  ]");
+    std::println("}}");
+
+    return EXIT_SUCCESS;
+}
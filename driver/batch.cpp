@@ -0,0 +1,78 @@
+#include "batch.h"
+#include "output/outputSink.h"
+#include "source/sourceBuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <optional>
+#include <print>
+#include <ostream>
+#include <system_error>
+#include <thread>
+
+namespace {
+
+ScriptResult runScript(const std::filesystem::path& path, Options options) {
+    CaptureSink outSink{};
+    CaptureSink errSink{};
+    std::ostream out{&outSink};
+    std::ostream err{&errSink};
+    int exitStatus{EXIT_SUCCESS};
+
+    std::optional<SourceBuffer> source{};
+    try {
+        source.emplace(SourceBuffer::fromFile(path.string()));
+    } catch (const std::system_error& e) {
+        std::println(err, "Could not read script: {}", e.what());
+        exitStatus = EXIT_FAILURE;
+    }
+
+    if (source.has_value()) {
+        Session session{options, out, err};
+        session.run(source->view());
+        session.printProfile();
+        exitStatus = session.exitStatus();
+    }
+
+    return ScriptResult{path, outSink.take(), errSink.take(), exitStatus};
+}
+
+} // namespace
+
+std::vector<std::filesystem::path> collectScripts(const std::filesystem::path& directory) {
+    std::vector<std::filesystem::path> scripts{};
+
+    for (const auto& entry : std::filesystem::recursive_directory_iterator{directory}) {
+        if (entry.is_regular_file() && entry.path().extension() == ".lox") {
+            scripts.push_back(entry.path());
+        }
+    }
+
+    std::sort(scripts.begin(), scripts.end());
+    return scripts;
+}
+
+std::vector<ScriptResult> runBatch(const std::vector<std::filesystem::path>& scripts,
+                                   Options options, std::size_t jobs) {
+    std::vector<ScriptResult> results(scripts.size());
+    std::atomic<std::size_t> next{0};
+
+    // Each worker claims the next unstarted script until none are left. Results are written to
+    // the script's own slot, so workers never touch the same element.
+    auto worker{[&] {
+        for (std::size_t i{next++}; i < scripts.size(); i = next++) {
+            results[i] = runScript(scripts[i], options);
+        }
+    }};
+
+    jobs = std::clamp<std::size_t>(jobs, 1, std::max<std::size_t>(scripts.size(), 1));
+    {
+        std::vector<std::jthread> pool{};
+        pool.reserve(jobs);
+        for (std::size_t i{0}; i < jobs; ++i) {
+            pool.emplace_back(worker);
+        }
+    } // jthreads join here.
+
+    return results;
+}
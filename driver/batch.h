@@ -0,0 +1,30 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "session.h"
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct ScriptResult {
+    std::filesystem::path path;
+    std::string out;
+    std::string err;
+    int exitStatus{0};
+};
+
+/*
+ * Every *.lox file under the directory (recursively), sorted by path so a batch always runs and
+ * reports its scripts in the same order.
+ */
+std::vector<std::filesystem::path> collectScripts(const std::filesystem::path& directory);
+
+/*
+ * Runs each script in its own Session on a pool of `jobs` worker threads, capturing its output.
+ * Results come back in the order of `scripts`, whichever thread finished first.
+ */
+std::vector<ScriptResult> runBatch(const std::vector<std::filesystem::path>& scripts,
+                                   Options options, std::size_t jobs);
+
+#endif // BATCH_H
@@ -0,0 +1,214 @@
+#include "session.h"
+#include "ast/constantFolder.h"
+#include "lexer/lexer.h"
+#include "lexer/parallelLexer.h"
+#include "parser/flatParser.h"
+#include "parser/parallelParser.h"
+#include "parser/parser.h"
+#include "vm/bytecodeCache.h"
+#include "vm/compiler.h"
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <print>
+
+Session::Session(Options options, std::ostream& out, std::ostream& err)
+    : m_options{options}, m_out{out}, m_err{err}, m_interpreter{out, err},
+      m_profilingInterpreter{out, err}, m_flatInterpreter{out, err}, m_closureInterpreter{out, err},
+      m_vm{out, err} {}
+
+void Session::run(std::string_view source) {
+    if (m_options.program) {
+        runProgram(source);
+        return;
+    }
+
+    // Allocations are counted against the phase in here, see --stats. Everything after parsing,
+    // folding and compiling included, counts as evaluation.
+    std::optional<AllocationStats::Scope> phase{};
+
+    bool cached{m_options.engine == Engine::_vm && m_options.cache};
+    if (cached) {
+        if (auto entry{BytecodeCache::global().load(source, m_options.optimize)}) {
+            phase.emplace(Phase::_evaluate);
+            // Reported as when the entry was compiled, -O output does not depend on the cache.
+            if (m_options.optimize) {
+                std::println(m_err, "Constant folding: {} nodes folded.", entry->foldedNodes);
+            }
+            m_vm.interpret(entry->chunk);
+            return;
+        }
+    }
+
+    if (m_options.engine == Engine::_flat) {
+        // Flat nodes index into the token list, so this engine cannot stream.
+        phase.emplace(Phase::_lex);
+        ParallelLexer lexer{source, m_options.threads, m_out, m_err};
+        auto tokens{lexer.lexTokens()};
+
+        // The arena, and with it every node, is released in one go when run() returns.
+        phase.emplace(Phase::_parse);
+        FlatParser parser{tokens, m_out, m_err};
+        auto ast{parser.parse()};
+
+        if (lexer.hadError() || parser.hadError()) {
+            m_hadSyntaxError = true;
+            return;
+        }
+
+        phase.emplace(Phase::_evaluate);
+        m_flatInterpreter.interpret(ast.value(), tokens);
+        return;
+    }
+
+    std::unique_ptr<Expression::Expression<Value>> expression{};
+    bool lexError{false};
+    bool parseError{false};
+
+    if (m_options.streaming) {
+        // Tokens are lexed as the parser reaches them and dropped right after, so lexer and
+        // parser errors are reported in source order rather than all lexer errors first. Lexing
+        // allocations count as parsing then.
+        phase.emplace(Phase::_parse);
+        Lexer lexer{source, m_out, m_err};
+        Parser<Value> parser{lexer, m_out, m_err};
+        expression = parser.parse();
+        lexError = lexer.hadError();
+        parseError = parser.hadError();
+    } else {
+        phase.emplace(Phase::_lex);
+        ParallelLexer lexer{source, m_options.threads, m_out, m_err};
+        auto tokens{lexer.lexTokens()};
+        lexError = lexer.hadError();
+        phase.emplace(Phase::_parse);
+        Parser<Value> parser{tokens, m_out, m_err};
+        expression = parser.parse();
+        parseError = parser.hadError();
+    }
+
+    if (lexError || parseError) {
+        m_hadSyntaxError = true;
+        return;
+    }
+
+    phase.emplace(Phase::_evaluate);
+    std::uint32_t foldedNodes{0};
+    if (m_options.optimize) {
+        // Only the pointer tree is optimized, the flat engine runs its AST as parsed.
+        ConstantFolder folder{};
+        expression = folder.fold(*expression);
+        foldedNodes = static_cast<std::uint32_t>(folder.foldedNodes());
+        std::println(m_err, "Constant folding: {} nodes folded.", foldedNodes);
+    }
+
+    switch (m_options.engine) {
+    case Engine::_tree:
+        // Picking the instrumented interpreter up front keeps checks off the evaluation path.
+        if (m_options.jit && !m_options.profile && runJit(*expression)) {
+            break;
+        }
+        if (m_options.profile) {
+            m_profilingInterpreter.interpret(*expression);
+        } else {
+            m_interpreter.interpret(*expression);
+        }
+        break;
+    case Engine::_flat:
+        // Handled above, it never builds a pointer tree.
+        break;
+    case Engine::_closure:
+        m_closureInterpreter.interpret(*expression);
+        break;
+    case Engine::_vm: {
+        Chunk chunk{};
+        Compiler{chunk}.compile(*expression);
+        // Only scripts that compile are cached, errors have to be reported on every run.
+        if (cached) {
+            BytecodeCache::global().store(source, m_options.optimize, chunk, foldedNodes);
+        }
+        m_vm.interpret(chunk);
+        break;
+    }
+    }
+}
+
+/*
+ * Statements have no flat, closure or bytecode form, so the tree interpreter runs every program.
+ * Nor does the constant folder handle them yet.
+ */
+void Session::runProgram(std::string_view source) {
+    std::optional<AllocationStats::Scope> phase{};
+    std::optional<Statement::Program<Value>> program{};
+    bool lexError{false};
+
+    if (m_options.streaming) {
+        phase.emplace(Phase::_parse);
+        Lexer lexer{source, m_out, m_err};
+        Parser<Value> parser{lexer, m_out, m_err};
+        program = parser.parseProgram();
+        lexError = lexer.hadError();
+    } else {
+        phase.emplace(Phase::_lex);
+        ParallelLexer lexer{source, m_options.threads, m_out, m_err};
+        auto tokens{lexer.lexTokens()};
+        lexError = lexer.hadError();
+        // Nodes copy their tokens, the program does not need the list once parsed.
+        phase.emplace(Phase::_parse);
+        program = ParallelParser<Value>{tokens, m_options.threads, m_out, m_err}.parseProgram();
+    }
+
+    if (lexError || !program.has_value()) {
+        m_hadSyntaxError = true;
+        return;
+    }
+
+    phase.emplace(Phase::_evaluate);
+    if (m_options.profile) {
+        m_profilingInterpreter.interpret(*program);
+    } else {
+        m_interpreter.interpret(*program);
+    }
+}
+
+bool Session::runJit(const Expression::Expression<Value>& expression) {
+    auto function{Jit::Compiler{}.compile(expression)};
+    if (!function.has_value()) {
+        return false;
+    }
+
+    // Scripts bind no inputs, so the guard cannot fail here, but it is just as cheap to honour.
+    auto value{function->evaluate({})};
+    if (!value.has_value()) {
+        return false;
+    }
+    m_out << *value << '\n';
+    return true;
+}
+
+bool Session::hadError() const {
+    return m_hadSyntaxError || m_interpreter.hadError() || m_profilingInterpreter.hadError() ||
+           m_flatInterpreter.hadError() || m_closureInterpreter.hadError() || m_vm.hadError();
+}
+
+bool Session::hadRuntimeError() const {
+    return m_interpreter.hadRuntimeError() || m_profilingInterpreter.hadRuntimeError() ||
+           m_flatInterpreter.hadRuntimeError() || m_closureInterpreter.hadRuntimeError() ||
+           m_vm.hadRuntimeError();
+}
+
+void Session::printProfile() const {
+    if (!m_options.profile) {
+        return;
+    }
+
+    if (m_options.engine != Engine::_tree) {
+        std::println(m_err, "Profiling is only available for the tree engine.");
+        return;
+    }
+    m_profilingInterpreter.report(m_err);
+}
+
+int Session::exitStatus() const {
+    return hadError() || hadRuntimeError() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
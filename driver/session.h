@@ -0,0 +1,83 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "interpreter/closureInterpreter.h"
+#include "interpreter/flatInterpreter.h"
+#include "interpreter/interpreter.h"
+#include "interpreter/profilingInterpreter.h"
+#include "jit/jitCompiler.h"
+#include "memory/allocationStats.h"
+#include "vm/vm.h"
+#include <cstddef>
+#include <iostream>
+#include <ostream>
+#include <string_view>
+
+enum class Engine {
+    _tree,    // reference tree-walking interpreter
+    _flat,    // tree-walker over the arena allocated flat AST
+    _vm,      // bytecode compiler and stack VM
+    _closure, // tree compiled once into directly linked closures
+};
+
+struct Options {
+    Engine engine{Engine::_tree};
+    bool streaming{false};
+    bool optimize{false};
+    bool profile{false}; // only the tree engine is instrumented
+    bool cache{true};    // only the vm engine has a compiled form worth caching
+    bool jit{false};     // tree engine only, for expressions that only compute with numbers
+    bool program{false}; // statement* EOF instead of one expression, always run by the tree engine
+    // Only large scripts are split, and never when streaming, see ParallelLexer and ParallelParser.
+    std::size_t threads{1};
+};
+
+/*
+ * Everything needed to run scripts: the options and one instance of each engine, all writing to
+ * the given streams. A session shares no state with other sessions, so each thread of a batch
+ * run gets its own; the REPL keeps one for its whole lifetime.
+ */
+class Session {
+  public:
+    explicit Session(Options options, std::ostream& out = std::cout,
+                     std::ostream& err = std::cerr);
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    Session(Session&&) noexcept = delete;
+    Session& operator=(Session&&) = delete;
+
+    ~Session() = default;
+
+    void run(std::string_view source);
+
+    bool hadError() const;
+    bool hadRuntimeError() const;
+
+    // What the process would exit with after running this session's scripts.
+    int exitStatus() const;
+
+    // Prints the --profile report to the error stream, nothing when profiling is off.
+    void printProfile() const;
+
+  private:
+    // Lexes, parses and runs the script as a program, see Options::program.
+    void runProgram(std::string_view source);
+
+    // Runs a number-only expression as native code, false if it is left to the interpreter.
+    bool runJit(const Expression::Expression<Value>& expression);
+
+    Options m_options;
+    std::ostream& m_out;
+    std::ostream& m_err;
+    bool m_hadSyntaxError{false};
+
+    Interpreter m_interpreter;
+    ProfilingInterpreter m_profilingInterpreter;
+    FlatInterpreter m_flatInterpreter;
+    ClosureInterpreter m_closureInterpreter;
+    VM m_vm;
+};
+
+#endif // SESSION_H
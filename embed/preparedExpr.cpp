@@ -0,0 +1,64 @@
+#include "preparedExpr.h"
+#include "ast/constantFolder.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "vm/compiler.h"
+#include "vm/vm.h"
+#include <exception>
+#include <print>
+#include <utility>
+
+namespace lox {
+
+auto PreparedExpr::evaluate(std::span<const Value> inputs) const
+    -> std::expected<Value, LoxRuntimeError> {
+    // run() only clears the stack, so its storage is kept for the next call on this thread.
+    thread_local VM vm{};
+
+    Value value{vm.run(m_chunk, inputs)};
+    if (auto error{vm.takeError()}) {
+        return std::unexpected{std::move(*error)};
+    }
+    return value;
+}
+
+auto compile(std::string_view source, std::span<const std::string_view> inputNames,
+             std::ostream& diagnostics) -> std::optional<PreparedExpr> {
+    try {
+        Lexer lexer{source, diagnostics, diagnostics};
+        auto tokens{lexer.lexTokens()};
+        Parser<Value> parser{tokens, diagnostics, diagnostics};
+        auto expression{parser.parse()};
+        if (lexer.hadError() || parser.hadError()) {
+            return std::nullopt;
+        }
+        // Whatever follows the expression would otherwise be dropped without a word.
+        if (!parser.expectEnd("Expect end of expression.")) {
+            return std::nullopt;
+        }
+        expression = ConstantFolder{}.fold(*expression);
+
+        // Declared inputs take the first slots, in order; the compiler appends anything else.
+        Chunk chunk{};
+        for (std::size_t slot{0}; slot < inputNames.size(); ++slot) {
+            if (chunk.addInput(inputNames[slot]) != slot) {
+                std::println(diagnostics, "Compile error: input '{}' is declared twice.",
+                             inputNames[slot]);
+                return std::nullopt;
+            }
+        }
+        Compiler{chunk}.compile(*expression);
+
+        if (chunk.inputs().size() > inputNames.size()) {
+            std::println(diagnostics, "Compile error: {}",
+                         undefinedVariable(chunk.inputs()[inputNames.size()]));
+            return std::nullopt;
+        }
+        return PreparedExpr{std::move(chunk)};
+    } catch (const std::exception& e) {
+        std::println(diagnostics, "Compile error: {}", e.what());
+        return std::nullopt;
+    }
+}
+
+} // namespace lox
@@ -0,0 +1,69 @@
+#ifndef PREPARED_EXPR_H
+#define PREPARED_EXPR_H
+
+#include "error/error.h"
+#include "typing/types.h"
+#include "vm/chunk.h"
+#include <expected>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Library entry point for programs embedding the interpreter: compile an expression once, then
+ * evaluate it as many times as needed with different values bound to its inputs.
+ */
+namespace lox {
+
+/*
+ * A compiled expression. Immutable once built, evaluate() only reads it, so one handle can be
+ * shared by any number of threads evaluating at the same time.
+ */
+class PreparedExpr {
+  public:
+    PreparedExpr(const PreparedExpr&) = delete;
+    PreparedExpr& operator=(const PreparedExpr&) = delete;
+
+    PreparedExpr(PreparedExpr&&) noexcept = default;
+    PreparedExpr& operator=(PreparedExpr&&) = default;
+
+    ~PreparedExpr() = default;
+
+    // In slot order, as passed to compile().
+    const std::vector<std::string>& inputNames() const {
+        return m_chunk.inputs();
+    }
+
+    /*
+     * Evaluates with inputs[i] bound to the i-th input name. Each thread reuses one VM across
+     * calls, so after its first call a thread allocates nothing beyond the strings the
+     * expression itself builds.
+     */
+    std::expected<Value, LoxRuntimeError> evaluate(std::span<const Value> inputs) const;
+
+  private:
+    friend std::optional<PreparedExpr> compile(std::string_view source,
+                                               std::span<const std::string_view> inputNames,
+                                               std::ostream& diagnostics);
+
+    explicit PreparedExpr(Chunk chunk) : m_chunk{std::move(chunk)} {}
+
+    Chunk m_chunk;
+};
+
+/*
+ * Lexes, parses, constant folds and compiles a single expression, which must be the whole source.
+ * Every name it uses must be one of inputNames. The source is not needed afterwards. Returns
+ * nothing, after reporting why to `diagnostics`, if the expression does not compile.
+ */
+std::optional<PreparedExpr> compile(std::string_view source,
+                                    std::span<const std::string_view> inputNames,
+                                    std::ostream& diagnostics = std::cerr);
+
+} // namespace lox
+
+#endif // PREPARED_EXPR_H
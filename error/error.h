@@ -3,8 +3,11 @@
 
 #include "typing/token.h"
 #include "typing/tokentypes.h"
+#include <iostream>
+#include <ostream>
 #include <print>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 
 struct LoxRuntimeError : public std::runtime_error {
@@ -14,11 +17,23 @@ struct LoxRuntimeError : public std::runtime_error {
         : std::runtime_error{static_cast<std::string>(message)}, m_token{token} {};
 };
 
+// Every engine reports a name with nothing bound to it with the same message.
+inline std::string undefinedVariable(std::string_view name) {
+    return std::string{"Undefined variable '"}.append(name).append("'.");
+}
+
+/*
+ * Each component owns its reporter, and with it the streams it writes to: `out` gets program
+ * output and user facing errors, `err` gets internal diagnostics. Components never share mutable
+ * state through it, so separate components can run on separate threads.
+ */
 class ErrorReporter {
   public:
-    ErrorReporter(std::string_view name) : m_name{name} {};
+    ErrorReporter(std::string_view name, std::ostream& out = std::cout,
+                  std::ostream& err = std::cerr)
+        : m_name{name}, m_out{&out}, m_err{&err} {};
     void report(int lineNumber, std::string_view where, std::string_view message) {
-        std::println("[line {}] Error{}: {}", lineNumber, where, message);
+        std::println(*m_out, "[line {}] Error{}: {}", lineNumber, where, message);
         m_hadError = true;
     }
 
@@ -26,16 +41,17 @@ class ErrorReporter {
         report(lineNumber, "", message);
     }
 
-    void error(Token token, std::string_view message) {
+    void error(const Token& token, std::string_view message) {
         if (token.getType() == TokenType::_eof)
             report(token.getLine(), " at end", message);
         else
-            report(token.getLine(), " at '" + token.getLexeme() + "'", message);
+            report(token.getLine(), std::string{" at '"}.append(token.getLexeme()).append("'"),
+                   message);
     }
 
     void runtimeError(LoxRuntimeError error) {
-        std::cout << error.what() << "\n";
-        std::cout << "[line " << error.m_token.getLine() << "]" << "\n";
+        *m_out << error.what() << "\n";
+        *m_out << "[line " << error.m_token.getLine() << "]" << "\n";
 
         m_hadRuntimeError = true;
     }
@@ -47,8 +63,17 @@ class ErrorReporter {
         return m_hadRuntimeError;
     };
 
+    std::ostream& out() const {
+        return *m_out;
+    }
+    std::ostream& err() const {
+        return *m_err;
+    }
+
   private:
     std::string m_name{"???"};
+    std::ostream* m_out;
+    std::ostream* m_err;
     bool m_hadError{false};
     bool m_hadRuntimeError{false};
 };
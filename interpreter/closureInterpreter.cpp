@@ -0,0 +1,262 @@
+#include "closureInterpreter.h"
+#include "typing/tokentypes.h"
+#include <exception>
+#include <functional>
+#include <print>
+#include <string_view>
+
+namespace {
+
+using Closure = ClosureInterpreter::Closure;
+using Error = ClosureInterpreter::Error;
+
+Value call(const Closure& closure, Error& error) {
+    return closure.function(closure, error);
+}
+
+Value fail(const Closure& closure, Error& error, std::string_view message) {
+    error.emplace(*closure.token, message);
+    return Value{};
+}
+
+/*
+ * One function per operator. Messages and type rules are the ones of Interpreter::visit(Binary)
+ * and Interpreter::visit(Unary).
+ */
+
+Value constant(const Closure& closure, Error&) {
+    return *closure.constant;
+}
+
+Value undefined(const Closure& closure, Error& error) {
+    // Scripts have nothing to bind names to yet.
+    return fail(closure, error, undefinedVariable(closure.token->getLexeme()));
+}
+
+Value add(const Closure& closure, Error& error) {
+    Value left{call(*closure.left, error)};
+    if (error) {
+        return Value{};
+    }
+    Value right{call(*closure.right, error)};
+    if (error) {
+        return Value{};
+    }
+
+    if (left.isNumber() && right.isNumber()) {
+        return left.asNumber() + right.asNumber();
+    }
+    if (left.isString() && right.isString()) {
+        return Value::concatenate(left, right);
+    }
+    return fail(closure, error, "Operands must be two numbers or two strings.");
+}
+
+template <typename Operation>
+Value arithmetic(const Closure& closure, Error& error) {
+    Value left{call(*closure.left, error)};
+    if (error) {
+        return Value{};
+    }
+    Value right{call(*closure.right, error)};
+    if (error) {
+        return Value{};
+    }
+
+    if (!left.isNumber() || !right.isNumber()) {
+        return fail(closure, error, "Binary operand must be a number.");
+    }
+    return Operation{}(left.asNumber(), right.asNumber());
+}
+
+// Never fails, Value orders and compares operands of any types.
+template <typename Comparison>
+Value comparison(const Closure& closure, Error& error) {
+    Value left{call(*closure.left, error)};
+    if (error) {
+        return Value{};
+    }
+    Value right{call(*closure.right, error)};
+    if (error) {
+        return Value{};
+    }
+    return Comparison{}(left, right);
+}
+
+Value negate(const Closure& closure, Error& error) {
+    Value right{call(*closure.right, error)};
+    if (error) {
+        return Value{};
+    }
+
+    if (!right.isNumber()) {
+        return fail(closure, error, "Unary operand must be a number.");
+    }
+    return -right.asNumber();
+}
+
+Value logicalNot(const Closure& closure, Error& error) {
+    Value right{call(*closure.right, error)};
+    if (error) {
+        return Value{};
+    }
+    return !right.isTruthy();
+}
+
+/*
+ * Appends the closures of a tree in postfix order. Operands, constants and tokens are kept as
+ * indices while the vectors can still grow, compile() turns them into pointers at the end.
+ */
+class ClosureCompiler : public Expression::Visitor<Value> {
+  public:
+    static constexpr std::size_t NONE{static_cast<std::size_t>(-1)};
+
+    struct Links {
+        std::size_t left;
+        std::size_t right;
+        std::size_t constant;
+        std::size_t token;
+    };
+
+    ClosureCompiler(std::vector<Closure>& closures, std::vector<Value>& constants,
+                    std::vector<Token>& tokens, std::vector<Links>& links)
+        : m_closures{closures}, m_constants{constants}, m_tokens{tokens}, m_links{links} {}
+
+    ClosureCompiler(const ClosureCompiler&) = delete;
+    ClosureCompiler& operator=(const ClosureCompiler&) = delete;
+
+    ClosureCompiler(ClosureCompiler&&) noexcept = delete;
+    ClosureCompiler& operator=(ClosureCompiler&&) = delete;
+
+    ~ClosureCompiler() = default;
+
+    Value visit(const Expression::Binary<Value>& expr) const override {
+        std::size_t left{compile(expr.left())};
+        std::size_t right{compile(expr.right())};
+        push(binary(expr.op().getType()), left, right, &expr.op());
+        return Value{};
+    }
+
+    Value visit(const Expression::Grouping<Value>& expr) const override {
+        return expr.expr().accept(*this);
+    }
+
+    Value visit(const Expression::Literal<Value>& expr) const override {
+        m_closures.push_back({constant, nullptr, nullptr, {nullptr}});
+        m_links.push_back({NONE, NONE, m_constants.size(), NONE});
+        m_constants.push_back(expr.getLiteral());
+        return Value{};
+    }
+
+    Value visit(const Expression::Unary<Value>& expr) const override {
+        std::size_t right{compile(expr.right())};
+        auto function{expr.op().getType() == TokenType::_minus ? negate : logicalNot};
+        push(function, NONE, right, &expr.op());
+        return Value{};
+    }
+
+    Value visit(const Expression::Variable<Value>& expr) const override {
+        push(undefined, NONE, NONE, &expr.name());
+        return Value{};
+    }
+
+  private:
+    static ClosureInterpreter::Function binary(TokenType type) {
+        switch (type) {
+        case TokenType::_plus:
+            return add;
+        case TokenType::_minus:
+            return arithmetic<std::minus<>>;
+        case TokenType::_star:
+            return arithmetic<std::multiplies<>>;
+        case TokenType::_slash:
+            // Since it's a double, division by 0 will not crash.
+            return arithmetic<std::divides<>>;
+        case TokenType::_greater:
+            return comparison<std::greater<>>;
+        case TokenType::_greater_equal:
+            return comparison<std::greater_equal<>>;
+        case TokenType::_less:
+            return comparison<std::less<>>;
+        case TokenType::_less_equal:
+            return comparison<std::less_equal<>>;
+        case TokenType::_equal_equal:
+            return comparison<std::equal_to<>>;
+        case TokenType::_bang_equal:
+            return comparison<std::not_equal_to<>>;
+        default:
+            // The parser never produces any other binary operator.
+            return constant;
+        }
+    }
+
+    // Index of the closure the subtree compiled to.
+    std::size_t compile(const Expression::Expression<Value>& expr) const {
+        expr.accept(*this);
+        return m_closures.size() - 1;
+    }
+
+    // An operator or name.
+    void push(ClosureInterpreter::Function function, std::size_t left, std::size_t right,
+              const Token* token) const {
+        m_closures.push_back({function, nullptr, nullptr, {nullptr}});
+        m_links.push_back({left, right, NONE, m_tokens.size()});
+        m_tokens.push_back(*token);
+    }
+
+    std::vector<Closure>& m_closures;
+    std::vector<Value>& m_constants;
+    std::vector<Token>& m_tokens;
+    std::vector<Links>& m_links;
+};
+
+} // namespace
+
+auto ClosureInterpreter::compile(const Expression::Expression<Value>& expression) -> Program {
+    Program program{};
+    std::vector<ClosureCompiler::Links> links{};
+    expression.accept(
+        ClosureCompiler{program.m_closures, program.m_constants, program.m_tokens, links});
+
+    // The vectors are final now, their elements stay where they are.
+    auto pointer{[](const auto& vector, std::size_t index) {
+        return index == ClosureCompiler::NONE ? nullptr : &vector[index];
+    }};
+    for (std::size_t i{0}; i < program.m_closures.size(); ++i) {
+        Closure& closure{program.m_closures[i]};
+        closure.left = pointer(program.m_closures, links[i].left);
+        closure.right = pointer(program.m_closures, links[i].right);
+        if (links[i].constant != ClosureCompiler::NONE) {
+            closure.constant = pointer(program.m_constants, links[i].constant);
+        } else {
+            closure.token = pointer(program.m_tokens, links[i].token);
+        }
+    }
+    return program;
+}
+
+void ClosureInterpreter::interpret(const Expression::Expression<Value>& expression) {
+    interpret(compile(expression));
+}
+
+void ClosureInterpreter::interpret(const Program& program) {
+    try {
+        m_error.reset();
+        Value value{evaluate(program)};
+
+        if (auto error{takeError()}) {
+            std::println(m_errorReporter.err(),
+                         "Lox runtime error caught at top level interpret(): {}", error->what());
+            m_errorReporter.runtimeError(*error);
+            return;
+        }
+        m_errorReporter.out() << value << '\n';
+    } catch (const std::exception& e) {
+        std::println(m_errorReporter.err(), "Unknown error caught at top level interpret(): {}",
+                     e.what());
+    }
+}
+
+Value ClosureInterpreter::evaluate(const Program& program) const {
+    return call(program.root(), m_error);
+}
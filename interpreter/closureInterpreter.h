@@ -0,0 +1,107 @@
+#ifndef CLOSURE_INTERPRETER_H
+#define CLOSURE_INTERPRETER_H
+
+#include "ast/expressionTrees.h"
+#include "error/error.h"
+#include "typing/token.h"
+#include "typing/types.h"
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/*
+ * Closure compiling interpreter. compile() walks the tree once and turns every node into a Closure
+ * holding a plain function pointer, picked for its operator at that point, and pointers to its
+ * operands. Evaluation then is one indirect call per node: no visitor dispatch and no switch on
+ * the operator. Groupings compile to their inner expression and cost nothing.
+ *
+ * Same semantics and error handling as Interpreter: a failing closure records the error and
+ * returns nil, every closure above it returns as soon as it sees it pending.
+ */
+class ClosureInterpreter {
+  public:
+    struct Closure;
+    using Error = std::optional<LoxRuntimeError>;
+    using Function = Value (*)(const Closure& closure, Error& error);
+
+    struct Closure {
+        Function function;
+        const Closure* left;
+        const Closure* right;
+        // Literals have a value, operators and names a token for runtime errors, never both. Both
+        // are kept out of line, so two closures fit in a cache line.
+        union {
+            const Value* constant;
+            const Token* token;
+        };
+    };
+    static_assert(sizeof(Closure) == 32);
+
+    /*
+     * A compiled expression. Closures only point at each other, so a program does not need the
+     * tree it was compiled from, only the source its tokens borrow from.
+     */
+    class Program {
+      public:
+        Program(const Program&) = delete;
+        Program& operator=(const Program&) = delete;
+
+        Program(Program&&) noexcept = default;
+        Program& operator=(Program&&) = default;
+
+        ~Program() = default;
+
+        const Closure& root() const {
+            return m_closures.back();
+        }
+        std::size_t size() const {
+            return m_closures.size();
+        }
+
+      private:
+        friend class ClosureInterpreter;
+
+        Program() = default;
+
+        // Operands always come before the closure using them, the root is last.
+        std::vector<Closure> m_closures;
+        std::vector<Value> m_constants;
+        std::vector<Token> m_tokens;
+    };
+
+    explicit ClosureInterpreter(std::ostream& out = std::cout, std::ostream& err = std::cerr)
+        : m_errorReporter{"ClosureInterpreter", out, err} {}
+
+    ClosureInterpreter(const ClosureInterpreter&) = delete;
+    ClosureInterpreter& operator=(const ClosureInterpreter&) = delete;
+
+    ClosureInterpreter(ClosureInterpreter&&) noexcept = delete;
+    ClosureInterpreter& operator=(ClosureInterpreter&&) = delete;
+
+    ~ClosureInterpreter() = default;
+
+    static Program compile(const Expression::Expression<Value>& expression);
+
+    void interpret(const Expression::Expression<Value>& expression);
+    void interpret(const Program& program);
+    Value evaluate(const Program& program) const;
+
+    // The error raised by the last evaluate(), if any, leaving none pending.
+    std::optional<LoxRuntimeError> takeError() const {
+        return std::exchange(m_error, std::nullopt);
+    }
+
+    bool hadError() const {
+        return m_errorReporter.hadError();
+    };
+    bool hadRuntimeError() const {
+        return m_errorReporter.hadRuntimeError();
+    };
+
+  private:
+    ErrorReporter m_errorReporter;
+    mutable Error m_error;
+};
+
+#endif // CLOSURE_INTERPRETER_H
@@ -0,0 +1,345 @@
+#include "columnInterpreter.h"
+#include "typing/tokentypes.h"
+#include <algorithm>
+
+// Kernels get AVX-512 and AVX2 clones next to the baseline one, the dynamic loader picks the best
+// one the CPU supports. The arch= spelling is GCC's.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define VECTOR_KERNEL __attribute__((target_clones("arch=x86-64-v4", "avx2", "default")))
+#else
+#define VECTOR_KERNEL
+#endif
+
+namespace {
+
+using Kind = ColumnInterpreter::Kind;
+constexpr std::size_t BLOCK_SIZE{ColumnInterpreter::BLOCK_SIZE};
+
+/*
+ * Every kernel writes its result over the left operand. The loops always run over a whole block,
+ * rows past the end of the input are garbage that is never copied out. Operands are loaded and
+ * both sides of every choice computed up front, so the compiler can turn the choices into selects
+ * and vectorize.
+ *
+ * Tracking kinds and errors costs several times the operation itself, so when every row of the
+ * operands is a number, by far the common case, a kernel runs a plain loop instead.
+ */
+
+[[gnu::always_inline]] inline bool allNumbers(const Kind* __restrict kinds) {
+    unsigned others{0};
+    for (std::size_t i{0}; i < BLOCK_SIZE; ++i) {
+        others |= kinds[i] != Kind::_number;
+    }
+    return others == 0;
+}
+
+// The left operand's error if it has one, else the right operand's, else the node's own.
+inline double firstError(Kind leftKind, double left, Kind rightKind, double right, double raised) {
+    return leftKind == Kind::_error ? left : rightKind == Kind::_error ? right : raised;
+}
+
+template <typename Op>
+[[gnu::always_inline]] inline void arithmeticLoop(double* __restrict left,
+                                                  Kind* __restrict leftKinds,
+                                                  const double* __restrict right,
+                                                  const Kind* __restrict rightKinds, double raised,
+                                                  Op op) {
+    if (allNumbers(leftKinds) && allNumbers(rightKinds)) {
+        for (std::size_t i{0}; i < BLOCK_SIZE; ++i) {
+            left[i] = op(left[i], right[i]);
+        }
+        return;
+    }
+
+    for (std::size_t i{0}; i < BLOCK_SIZE; ++i) {
+        Kind leftKind{leftKinds[i]};
+        Kind rightKind{rightKinds[i]};
+        bool numbers{leftKind == Kind::_number && rightKind == Kind::_number};
+        double leftValue{left[i]};
+        double rightValue{right[i]};
+        double result{op(leftValue, rightValue)};
+        double error{firstError(leftKind, leftValue, rightKind, rightValue, raised)};
+        left[i] = numbers ? result : error;
+        leftKinds[i] = numbers ? Kind::_number : Kind::_error;
+    }
+}
+
+template <typename Op>
+[[gnu::always_inline]] inline void booleanLoop(double* __restrict left, Kind* __restrict leftKinds,
+                                               const double* __restrict right,
+                                               const Kind* __restrict rightKinds, Op op) {
+    if (allNumbers(leftKinds) && allNumbers(rightKinds)) {
+        for (std::size_t i{0}; i < BLOCK_SIZE; ++i) {
+            left[i] = op(Kind::_number, left[i], Kind::_number, right[i]) ? 1.0 : 0.0;
+        }
+        std::fill_n(leftKinds, BLOCK_SIZE, Kind::_boolean);
+        return;
+    }
+
+    for (std::size_t i{0}; i < BLOCK_SIZE; ++i) {
+        Kind leftKind{leftKinds[i]};
+        Kind rightKind{rightKinds[i]};
+        bool failed{leftKind == Kind::_error || rightKind == Kind::_error};
+        double leftValue{left[i]};
+        double rightValue{right[i]};
+        double error{firstError(leftKind, leftValue, rightKind, rightValue, 0.0)};
+        double result{op(leftKind, leftValue, rightKind, rightValue) ? 1.0 : 0.0};
+        left[i] = failed ? error : result;
+        leftKinds[i] = failed ? Kind::_error : Kind::_boolean;
+    }
+}
+
+// Ordering across kinds follows Value: nil < booleans < numbers, which is the order of Kind.
+// Nil rows hold 0, so comparing (kind, value) pairs gives nil == nil as well.
+struct Less {
+    bool operator()(Kind leftKind, double left, Kind rightKind, double right) const {
+        return leftKind < rightKind || (leftKind == rightKind && left < right);
+    }
+};
+struct LessEqual {
+    bool operator()(Kind leftKind, double left, Kind rightKind, double right) const {
+        return leftKind < rightKind || (leftKind == rightKind && left <= right);
+    }
+};
+struct Equal {
+    bool operator()(Kind leftKind, double left, Kind rightKind, double right) const {
+        return leftKind == rightKind && left == right;
+    }
+};
+template <typename Op>
+struct Swapped {
+    bool operator()(Kind leftKind, double left, Kind rightKind, double right) const {
+        return Op{}(rightKind, right, leftKind, left);
+    }
+};
+template <typename Op>
+struct Negated {
+    bool operator()(Kind leftKind, double left, Kind rightKind, double right) const {
+        return !Op{}(leftKind, left, rightKind, right);
+    }
+};
+
+VECTOR_KERNEL void arithmetic(TokenType op, double* left, Kind* leftKinds, const double* right,
+                              const Kind* rightKinds, double raised) {
+    switch (op) {
+    case TokenType::_plus:
+        arithmeticLoop(left, leftKinds, right, rightKinds, raised,
+                       [](double a, double b) { return a + b; });
+        break;
+    case TokenType::_minus:
+        arithmeticLoop(left, leftKinds, right, rightKinds, raised,
+                       [](double a, double b) { return a - b; });
+        break;
+    case TokenType::_star:
+        arithmeticLoop(left, leftKinds, right, rightKinds, raised,
+                       [](double a, double b) { return a * b; });
+        break;
+    case TokenType::_slash:
+        arithmeticLoop(left, leftKinds, right, rightKinds, raised,
+                       [](double a, double b) { return a / b; });
+        break;
+    default:
+        break;
+    }
+}
+
+VECTOR_KERNEL void comparison(TokenType op, double* left, Kind* leftKinds, const double* right,
+                              const Kind* rightKinds) {
+    switch (op) {
+    case TokenType::_less:
+        booleanLoop(left, leftKinds, right, rightKinds, Less{});
+        break;
+    case TokenType::_less_equal:
+        booleanLoop(left, leftKinds, right, rightKinds, LessEqual{});
+        break;
+    case TokenType::_greater:
+        booleanLoop(left, leftKinds, right, rightKinds, Swapped<Less>{});
+        break;
+    case TokenType::_greater_equal:
+        booleanLoop(left, leftKinds, right, rightKinds, Swapped<LessEqual>{});
+        break;
+    case TokenType::_equal_equal:
+        booleanLoop(left, leftKinds, right, rightKinds, Equal{});
+        break;
+    case TokenType::_bang_equal:
+        booleanLoop(left, leftKinds, right, rightKinds, Negated<Equal>{});
+        break;
+    default:
+        break;
+    }
+}
+
+VECTOR_KERNEL void negate(double* __restrict values, Kind* __restrict kinds, double raised) {
+    if (allNumbers(kinds)) {
+        for (std::size_t i{0}; i < BLOCK_SIZE; ++i) {
+            values[i] = -values[i];
+        }
+        return;
+    }
+
+    for (std::size_t i{0}; i < BLOCK_SIZE; ++i) {
+        Kind kind{kinds[i]};
+        bool number{kind == Kind::_number};
+        double result{-values[i]};
+        double error{kind == Kind::_error ? values[i] : raised};
+        values[i] = number ? result : error;
+        kinds[i] = number ? Kind::_number : Kind::_error;
+    }
+}
+
+VECTOR_KERNEL void logicalNot(double* __restrict values, Kind* __restrict kinds) {
+    for (std::size_t i{0}; i < BLOCK_SIZE; ++i) {
+        Kind kind{kinds[i]};
+        double value{values[i]};
+        bool failed{kind == Kind::_error};
+        // nil and false are falsey, everything else is truthy.
+        bool falsey{kind == Kind::_nil || (kind == Kind::_boolean && value == 0.0)};
+        double result{falsey ? 1.0 : 0.0};
+        values[i] = failed ? value : result;
+        kinds[i] = failed ? Kind::_error : Kind::_boolean;
+    }
+}
+
+} // namespace
+
+bool ColumnInterpreter::evaluate(const Expression::Expression<Value>& expr,
+                                 std::span<const Column> inputs, std::span<Kind> kinds,
+                                 std::span<double> values) {
+    m_inputs = inputs;
+    m_errors.clear();
+    m_unsupported = false;
+
+    for (std::size_t begin{0}; begin < kinds.size(); begin += BLOCK_SIZE) {
+        m_begin = begin;
+        m_rows = std::min(BLOCK_SIZE, kinds.size() - begin);
+        m_top = 0;
+        m_nextError = 0;
+
+        expr.accept(*this);
+        // Only ever set on the first block, before anything has been written.
+        if (m_unsupported) {
+            return false;
+        }
+
+        const Block& result{top()};
+        std::copy_n(result.kinds.begin(), m_rows, kinds.begin() + begin);
+        std::copy_n(result.values.begin(), m_rows, values.begin() + begin);
+    }
+    return true;
+}
+
+Value ColumnInterpreter::visit(const Expression::Binary<Value>& expr) const {
+    expr.left().accept(*this);
+    expr.right().accept(*this);
+
+    // Both children are on the stack now, it does not grow again until this node is done.
+    Block& left{top(1)};
+    const Block& right{top()};
+    TokenType op{expr.op().getType()};
+
+    switch (op) {
+    case TokenType::_plus:
+        arithmetic(op, left.values.data(), left.kinds.data(), right.values.data(),
+                   right.kinds.data(),
+                   raise(expr.op(), "Operands must be two numbers or two strings."));
+        break;
+    case TokenType::_minus:
+    case TokenType::_star:
+    case TokenType::_slash:
+        arithmetic(op, left.values.data(), left.kinds.data(), right.values.data(),
+                   right.kinds.data(), raise(expr.op(), "Binary operand must be a number."));
+        break;
+    default:
+        comparison(op, left.values.data(), left.kinds.data(), right.values.data(),
+                   right.kinds.data());
+        break;
+    }
+
+    --m_top;
+    return Value{};
+}
+
+Value ColumnInterpreter::visit(const Expression::Grouping<Value>& expr) const {
+    return expr.expr().accept(*this);
+}
+
+Value ColumnInterpreter::visit(const Expression::Literal<Value>& expr) const {
+    const Value& literal{expr.getLiteral()};
+    Block& block{push()};
+
+    if (literal.isNumber()) {
+        fill(block, Kind::_number, literal.asNumber());
+    } else if (literal.isBoolean()) {
+        fill(block, Kind::_boolean, literal.asBoolean() ? 1.0 : 0.0);
+    } else {
+        m_unsupported = m_unsupported || literal.isString();
+        fill(block, Kind::_nil, 0.0);
+    }
+    return Value{};
+}
+
+Value ColumnInterpreter::visit(const Expression::Unary<Value>& expr) const {
+    expr.right().accept(*this);
+    Block& block{top()};
+
+    if (expr.op().getType() == TokenType::_minus) {
+        negate(block.values.data(), block.kinds.data(),
+               raise(expr.op(), "Unary operand must be a number."));
+    } else {
+        logicalNot(block.values.data(), block.kinds.data());
+    }
+    return Value{};
+}
+
+Value ColumnInterpreter::visit(const Expression::Variable<Value>& expr) const {
+    Block& block{push()};
+
+    auto column{std::find_if(m_inputs.begin(), m_inputs.end(), [&](const Column& input) {
+        return input.name == expr.name().getLexeme();
+    })};
+    if (column == m_inputs.end()) {
+        fill(block, Kind::_error,
+             raise(expr.name(), undefinedVariable(expr.name().getLexeme())));
+        return Value{};
+    }
+
+    // Rows past the end of the input are left nil.
+    if (m_rows < BLOCK_SIZE) {
+        fill(block, Kind::_nil, 0.0);
+    }
+    std::copy_n(column->values.begin() + m_begin, m_rows, block.values.begin());
+    if (column->present.empty()) {
+        std::fill_n(block.kinds.begin(), m_rows, Kind::_number);
+    } else {
+        for (std::size_t i{0}; i < m_rows; ++i) {
+            bool present{column->present[m_begin + i] != 0};
+            block.kinds[i] = present ? Kind::_number : Kind::_nil;
+            block.values[i] = present ? block.values[i] : 0.0;
+        }
+    }
+    return Value{};
+}
+
+auto ColumnInterpreter::push() const -> Block& {
+    if (m_top == m_blocks.size()) {
+        m_blocks.emplace_back();
+    }
+    return m_blocks[m_top++];
+}
+
+auto ColumnInterpreter::top(std::size_t depth) const -> Block& {
+    return m_blocks[m_top - 1 - depth];
+}
+
+void ColumnInterpreter::fill(Block& block, Kind kind, double value) const {
+    block.kinds.fill(kind);
+    block.values.fill(value);
+}
+
+double ColumnInterpreter::raise(const Token& token, std::string_view message) const {
+    // Nodes are visited in the same order on every block, so the n-th call is the same node.
+    if (m_nextError == m_errors.size()) {
+        m_errors.emplace_back(token, message);
+    }
+    return static_cast<double>(m_nextError++);
+}
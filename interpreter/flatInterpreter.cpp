@@ -0,0 +1,148 @@
+#include "flatInterpreter.h"
+#include "error/error.h"
+#include "typing/tokentypes.h"
+#include <exception>
+#include <print>
+
+void FlatInterpreter::interpret(const Flat::Ast& ast, const TokenList& tokens) {
+    try {
+        m_failure.reset();
+        Value value{evaluate(ast, tokens, ast.root())};
+
+        if (m_failure.has_value()) {
+            LoxRuntimeError error{tokens.token(m_failure->token), m_failure->message};
+            m_failure.reset();
+            std::println(m_errorReporter.err(),
+                         "Lox runtime error caught at top level interpret(): {}", error.what());
+            m_errorReporter.runtimeError(error);
+            return;
+        }
+        m_errorReporter.out() << value << '\n';
+    } catch (const std::exception& e) {
+        std::println(m_errorReporter.err(), "Unknown error caught at top level interpret(): {}",
+                     e.what());
+    }
+}
+
+Value FlatInterpreter::evaluate(const Flat::Ast& ast, const TokenList& tokens,
+                                Flat::NodeIndex index) const {
+    const Flat::Node& node{ast[index]};
+
+    switch (node.kind) {
+    case Flat::NodeKind::_binary:
+        return binary(ast, tokens, node);
+    case Flat::NodeKind::_grouping:
+        return evaluate(ast, tokens, node.lhs);
+    case Flat::NodeKind::_literal:
+        switch (node.op) {
+        case TokenType::_true:
+            return true;
+        case TokenType::_false:
+            return false;
+        case TokenType::_nil:
+            return Value{};
+        default:
+            return tokens.literal(node.token);
+        }
+    case Flat::NodeKind::_unary:
+        return unary(ast, tokens, node);
+    case Flat::NodeKind::_variable:
+        // Scripts have nothing to bind names to yet.
+        return fail(node, undefinedVariable(tokens.lexeme(node.token)));
+    }
+
+    // Unreachable.
+    return Value{};
+}
+
+Value FlatInterpreter::binary(const Flat::Ast& ast, const TokenList& tokens,
+                              const Flat::Node& node) const {
+
+    auto left{evaluate(ast, tokens, node.lhs)};
+    if (m_failure) {
+        return Value{};
+    }
+    auto right{evaluate(ast, tokens, node.rhs)};
+    if (m_failure) {
+        return Value{};
+    }
+
+    bool bothNumbers{left.isNumber() && right.isNumber()};
+
+    // See Interpreter::visit(Binary) for the semantics, this mirrors it exactly.
+    switch (node.op) {
+    case TokenType::_plus:
+        if (bothNumbers) {
+            return left.asNumber() + right.asNumber();
+        } else if (left.isString() && right.isString()) {
+            return Value::concatenate(left, right);
+        }
+
+        return fail(node, "Operands must be two numbers or two strings.");
+
+    case TokenType::_minus:
+        if (!bothNumbers) {
+            return fail(node, "Binary operand must be a number.");
+        }
+        return left.asNumber() - right.asNumber();
+
+    case TokenType::_slash:
+        if (!bothNumbers) {
+            return fail(node, "Binary operand must be a number.");
+        }
+        return left.asNumber() / right.asNumber();
+
+    case TokenType::_star:
+        if (!bothNumbers) {
+            return fail(node, "Binary operand must be a number.");
+        }
+        return left.asNumber() * right.asNumber();
+
+    case TokenType::_greater:
+        return left > right;
+
+    case TokenType::_greater_equal:
+        return left >= right;
+
+    case TokenType::_less:
+        return left < right;
+
+    case TokenType::_less_equal:
+        return left <= right;
+
+    case TokenType::_equal_equal:
+        return left == right;
+
+    case TokenType::_bang_equal:
+        return left != right;
+
+    default:
+        return Value{};
+    }
+}
+
+Value FlatInterpreter::unary(const Flat::Ast& ast, const TokenList& tokens,
+                             const Flat::Node& node) const {
+
+    auto right{evaluate(ast, tokens, node.lhs)};
+    if (m_failure) {
+        return Value{};
+    }
+
+    switch (node.op) {
+    case TokenType::_minus:
+        if (!right.isNumber()) {
+            return fail(node, "Unary operand must be a number.");
+        }
+        return -right.asNumber();
+    case TokenType::_bang:
+        return !right.isTruthy();
+    default:
+        return Value{};
+    }
+}
+
+Value FlatInterpreter::fail(const Flat::Node& node, std::string_view message) const {
+    m_failure.emplace(node.token, std::string{message});
+    return Value{};
+}
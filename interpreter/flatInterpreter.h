@@ -0,0 +1,60 @@
+#ifndef FLAT_INTERPRETER_H
+#define FLAT_INTERPRETER_H
+
+#include "ast/flatAst.h"
+#include "error/error.h"
+#include "lexer/tokenList.h"
+#include "typing/types.h"
+#include <optional>
+#include <string>
+#include <string_view>
+
+/*
+ * Tree-walking interpreter over a Flat::Ast. Same semantics as Interpreter, but walks indices in
+ * a contiguous arena instead of virtual calls through heap allocated nodes.
+ *
+ * Runtime errors propagate without unwinding, like in Interpreter. Only the token index and the
+ * message are kept on the way up; the Token is built once, for the report.
+ */
+class FlatInterpreter {
+  public:
+    explicit FlatInterpreter(std::ostream& out = std::cout, std::ostream& err = std::cerr)
+        : m_errorReporter{"FlatInterpreter", out, err} {}
+
+    FlatInterpreter(const FlatInterpreter&) = delete;
+    FlatInterpreter& operator=(const FlatInterpreter&) = delete;
+
+    FlatInterpreter(FlatInterpreter&&) noexcept = delete;
+    FlatInterpreter& operator=(FlatInterpreter&&) = delete;
+
+    ~FlatInterpreter() = default;
+
+    void interpret(const Flat::Ast& ast, const TokenList& tokens);
+    Value evaluate(const Flat::Ast& ast, const TokenList& tokens,
+                   Flat::NodeIndex index) const;
+
+    bool hadError() const {
+        return m_errorReporter.hadError();
+    };
+    bool hadRuntimeError() const {
+        return m_errorReporter.hadRuntimeError();
+    };
+
+  private:
+    struct Failure {
+        Flat::TokenIndex token;
+        std::string message;
+    };
+
+    Value fail(const Flat::Node& node, std::string_view message) const;
+
+    Value binary(const Flat::Ast& ast, const TokenList& tokens,
+                 const Flat::Node& node) const;
+    Value unary(const Flat::Ast& ast, const TokenList& tokens,
+                const Flat::Node& node) const;
+
+    ErrorReporter m_errorReporter;
+    mutable std::optional<Failure> m_failure;
+};
+
+#endif // FLAT_INTERPRETER_H
@@ -1,13 +1,27 @@
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
 #include "ast/expressionTrees.h"
+#include "ast/statementTrees.h"
 #include "error/error.h"
 #include "typing/types.h"
+#include <optional>
+#include <string_view>
+#include <utility>
 
 /*
  * Tree-walking interpreter.
+ *
+ * Runtime errors do not throw: the failing node records the error and returns nil, and every node
+ * above it returns as soon as it sees the pending error. interpret() reports it once evaluation is
+ * back at the top. An Interpreter therefore evaluates one tree at a time.
+ *
+ * A program runs its statements in order and stops at the first runtime error.
  */
-class Interpreter : public Expression::Visitor<Type> {
+class Interpreter : public Expression::Visitor<Value>, public Statement::Visitor<Value> {
   public:
-    Interpreter() = default;
+    explicit Interpreter(std::ostream& out = std::cout, std::ostream& err = std::cerr)
+        : m_errorReporter{"Interpreter", out, err} {}
 
     Interpreter(const Interpreter&) = delete;
     Interpreter& operator=(const Interpreter&) = delete;
@@ -17,14 +31,24 @@ class Interpreter : public Expression::Visitor<Type> {
 
     ~Interpreter() = default;
 
-    void interpret(const Expression::Expression<Type>& expression);
-    Type evaluate(const Expression::Expression<Type>& expr) const;
-    Type visit(const Expression::Binary<Type>& expr) const;
-    Type visit(const Expression::Grouping<Type>& expr) const;
-    Type visit(const Expression::Literal<Type>& expr) const;
-    Type visit(const Expression::Unary<Type>& expr) const;
-    void checkNumberOperand(Token opertor, Type operand) const;
-    void checkNumberOperands(Token opertor, Type leftOperand, Type rightOperand) const;
+    void interpret(const Expression::Expression<Value>& expression);
+    void interpret(const Statement::Program<Value>& program);
+    Value evaluate(const Expression::Expression<Value>& expr) const;
+    Value visit(const Expression::Binary<Value>& expr) const;
+    Value visit(const Expression::Grouping<Value>& expr) const;
+    Value visit(const Expression::Literal<Value>& expr) const;
+    Value visit(const Expression::Unary<Value>& expr) const;
+    Value visit(const Expression::Variable<Value>& expr) const;
+    Value visit(const Statement::ExpressionStatement<Value>& stmt) const;
+    Value visit(const Statement::PrintStatement<Value>& stmt) const;
+    bool checkNumberOperand(const Token& opertor, const Value& operand) const;
+    bool checkNumberOperands(const Token& opertor, const Value& leftOperand,
+                             const Value& rightOperand) const;
+
+    // The error raised by the last evaluate(), if any, leaving none pending.
+    std::optional<LoxRuntimeError> takeError() const {
+        return std::exchange(m_error, std::nullopt);
+    }
 
     bool hadError() const {
         return m_errorReporter.hadError();
@@ -33,6 +57,14 @@ class Interpreter : public Expression::Visitor<Type> {
         return m_errorReporter.hadRuntimeError();
     };
 
+  protected:
+    // Records a runtime error, the returned nil is never looked at.
+    Value fail(const Token& opertor, std::string_view message) const;
+
+    mutable std::optional<LoxRuntimeError> m_error;
+
   private:
-    ErrorReporter m_errorReporter{"Interpreter"};
+    ErrorReporter m_errorReporter;
 };
+
+#endif // INTERPRETER_H
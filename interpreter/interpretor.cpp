@@ -4,61 +4,106 @@
 #include "typing/types.h"
 #include <exception>
 #include <print>
-#include <variant>
 
-void Interpreter::interpret(const Expression::Expression<Type>& expression) {
+void Interpreter::interpret(const Expression::Expression<Value>& expression) {
     try {
-        Type value{evaluate(expression)};
-        std::cout << value << std::endl;
-    } catch (const LoxRuntimeError& e) {
-        std::println(std::cerr, "Lox runtime error caught at top level interpret(): {}", e.what());
-        m_errorReporter.runtimeError(e);
+        m_error.reset();
+        Value value{evaluate(expression)};
+
+        if (auto error{takeError()}) {
+            std::println(m_errorReporter.err(),
+                         "Lox runtime error caught at top level interpret(): {}", error->what());
+            m_errorReporter.runtimeError(*error);
+            return;
+        }
+        m_errorReporter.out() << value << '\n';
+    } catch (const std::exception& e) {
+        std::println(m_errorReporter.err(), "Unknown error caught at top level interpret(): {}",
+                     e.what());
+    }
+}
+
+void Interpreter::interpret(const Statement::Program<Value>& program) {
+    try {
+        m_error.reset();
+        for (const auto& statement : program) {
+            statement->accept(*this);
+
+            if (auto error{takeError()}) {
+                std::println(m_errorReporter.err(),
+                             "Lox runtime error caught at top level interpret(): {}",
+                             error->what());
+                m_errorReporter.runtimeError(*error);
+                return;
+            }
+        }
     } catch (const std::exception& e) {
-        std::println(std::cerr, "Unknown error caught at top level interpret(): {}", e.what());
+        std::println(m_errorReporter.err(), "Unknown error caught at top level interpret(): {}",
+                     e.what());
+    }
+}
+
+Value Interpreter::visit(const Statement::ExpressionStatement<Value>& stmt) const {
+    evaluate(stmt.expr());
+    return Value{};
+}
+
+Value Interpreter::visit(const Statement::PrintStatement<Value>& stmt) const {
+    Value value{evaluate(stmt.expr())};
+    if (!m_error) {
+        m_errorReporter.out() << value << '\n';
     }
+    return Value{};
 }
 
-Type Interpreter::evaluate(const Expression::Expression<Type>& expr) const {
+Value Interpreter::evaluate(const Expression::Expression<Value>& expr) const {
     return expr.accept(*this);
 }
-Type Interpreter::visit(const Expression::Binary<Type>& expr) const {
+Value Interpreter::visit(const Expression::Binary<Value>& expr) const {
 
     auto left{evaluate(expr.left())};
+    if (m_error) {
+        return Value{};
+    }
     auto right{evaluate(expr.right())};
+    if (m_error) {
+        return Value{};
+    }
 
     switch (expr.op().getType()) {
-    // TODO: Handle null optionals rather than .value.
-    // TODO: What if std::get fails? i.e. wrong variant? Right now it throws bad optional access, as
-    // per C++ rules.
     case TokenType::_plus:
         // TODO: Clean this up, and perhaps support boolean additions?
-        if (std::holds_alternative<Number>(left.value()) &&
-            std::holds_alternative<Number>(right.value())) {
-            return std::get<Number>(left.value()) + std::get<Number>(right.value());
-        } else if (std::holds_alternative<String>(left.value()) &&
-                   std::holds_alternative<String>(right.value())) {
-            return std::get<String>(left.value()) + std::get<String>(right.value());
+        if (left.isNumber() && right.isNumber()) {
+            return left.asNumber() + right.asNumber();
+        } else if (left.isString() && right.isString()) {
+            return Value::concatenate(left, right);
         }
 
-        throw LoxRuntimeError{expr.op(), "Operands must be two numbers or two strings."};
+        return fail(expr.op(), "Operands must be two numbers or two strings.");
 
     case TokenType::_minus:
-        checkNumberOperands(expr.op(), left, right);
-        return std::get<Number>(left.value()) - std::get<Number>(right.value());
+        if (!checkNumberOperands(expr.op(), left, right)) {
+            return Value{};
+        }
+        return left.asNumber() - right.asNumber();
 
     case TokenType::_slash:
         // Since it's a double, division by 0 will not crash.
-        checkNumberOperands(expr.op(), left, right);
-        return std::get<Number>(left.value()) / std::get<Number>(right.value());
+        if (!checkNumberOperands(expr.op(), left, right)) {
+            return Value{};
+        }
+        return left.asNumber() / right.asNumber();
 
     case TokenType::_star:
-        checkNumberOperands(expr.op(), left, right);
-        return std::get<Number>(left.value()) * std::get<Number>(right.value());
+        if (!checkNumberOperands(expr.op(), left, right)) {
+            return Value{};
+        }
+        return left.asNumber() * right.asNumber();
 
-    // Rely on the variant operators overloads themselves.
-    // Null values are treated as less than any other values.
-    // Null values are equal to each other.
-    // Underlying variant type is compared if not null.
+    // Rely on the Value comparison operators.
+    // Nil values are treated as less than any other values.
+    // Nil values are equal to each other.
+    // Different types are ordered boolean < number < string, same types compare their contents.
     case TokenType::_greater:
         return left > right;
 
@@ -78,59 +123,72 @@ Type Interpreter::visit(const Expression::Binary<Type>& expr) const {
         return left != right;
 
     default:
-        return std::nullopt;
+        return Value{};
     }
 
     // Unreachable.
-    return std::nullopt;
+    return Value{};
 }
 
-Type Interpreter::visit(const Expression::Grouping<Type>& expr) const {
+Value Interpreter::visit(const Expression::Grouping<Value>& expr) const {
     return evaluate(expr.expr());
 }
 
-Type Interpreter::visit(const Expression::Literal<Type>& expr) const {
+Value Interpreter::visit(const Expression::Literal<Value>& expr) const {
     return expr.getLiteral();
 }
 
-Type Interpreter::visit(const Expression::Unary<Type>& expr) const {
+Value Interpreter::visit(const Expression::Unary<Value>& expr) const {
 
     auto right{evaluate(expr.right())};
+    if (m_error) {
+        return Value{};
+    }
 
     switch (expr.op().getType()) {
-    // TODO: Handle null optionals rather than .value.
-    // TODO: What if std::get fails? i.e. wrong variant?
     case TokenType::_minus:
-        checkNumberOperand(expr.op(), right);
-        return std::get<Number>(right.value());
+        if (!checkNumberOperand(expr.op(), right)) {
+            return Value{};
+        }
+        return -right.asNumber();
     case TokenType::_bang:
-        // TODO: handle NULL values?
-        // what is truthy?
-        return !std::get<Boolean>(right.value());
+        // nil and false are falsey, everything else is truthy.
+        return !right.isTruthy();
     default:
-        return std::nullopt;
+        return Value{};
     }
 
     // Unreachable.
-    return std::nullopt;
+    return Value{};
+}
+
+Value Interpreter::visit(const Expression::Variable<Value>& expr) const {
+    // Scripts have nothing to bind names to yet.
+    return fail(expr.name(), undefinedVariable(expr.name().getLexeme()));
 }
 
-void Interpreter::checkNumberOperand(Token opertor, Type operand) const {
+bool Interpreter::checkNumberOperand(const Token& opertor, const Value& operand) const {
 
-    if (operand.has_value() && std::holds_alternative<Number>(operand.value())) {
-        return;
+    if (operand.isNumber()) {
+        return true;
     }
 
-    throw LoxRuntimeError{opertor, "Unary operand must be a number."};
+    fail(opertor, "Unary operand must be a number.");
+    return false;
 }
 
-void Interpreter::checkNumberOperands(Token opertor, Type leftOperand, Type rightOperand) const {
+bool Interpreter::checkNumberOperands(const Token& opertor, const Value& leftOperand,
+                                      const Value& rightOperand) const {
 
-    if (leftOperand.has_value() && rightOperand.has_value() &&
-        std::holds_alternative<Number>(leftOperand.value()) &&
-        std::holds_alternative<Number>(rightOperand.value())) {
-        return;
+    if (leftOperand.isNumber() && rightOperand.isNumber()) {
+        return true;
     }
 
-    throw LoxRuntimeError{opertor, "Binary operand must be a number."};
+    fail(opertor, "Binary operand must be a number.");
+    return false;
+}
+
+Value Interpreter::fail(const Token& opertor, std::string_view message) const {
+    m_error.emplace(opertor, message);
+    return Value{};
 }
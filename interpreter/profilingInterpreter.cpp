@@ -0,0 +1,105 @@
+#include "profilingInterpreter.h"
+#include <algorithm>
+#include <print>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+template <typename Visit>
+Value ProfilingInterpreter::profile(Entry& entry, int line, Visit visit) const {
+    Clock::duration outerChildTime{std::exchange(m_childTime, Clock::duration{})};
+    int outerLine{std::exchange(m_line, line)};
+
+    auto start{Clock::now()};
+    // A node that fails still returns here, it is recorded like any other.
+    Value value{visit()};
+    Clock::duration elapsed{Clock::now() - start};
+
+    Clock::duration self{elapsed - m_childTime};
+    entry.count += 1;
+    entry.self += self;
+    entry.total += elapsed;
+
+    Entry& lineEntry{m_lines[line]};
+    lineEntry.count += 1;
+    lineEntry.self += self;
+    lineEntry.total += elapsed;
+
+    m_childTime = outerChildTime + elapsed;
+    m_line = outerLine;
+    return value;
+}
+
+Value ProfilingInterpreter::visit(const Expression::Binary<Value>& expr) const {
+    return profile(m_binary[static_cast<std::size_t>(expr.op().getType())], expr.op().getLine(),
+                   [&] { return Interpreter::visit(expr); });
+}
+
+Value ProfilingInterpreter::visit(const Expression::Grouping<Value>& expr) const {
+    return profile(m_grouping, m_line, [&] { return Interpreter::visit(expr); });
+}
+
+Value ProfilingInterpreter::visit(const Expression::Literal<Value>& expr) const {
+    return profile(m_literal, m_line, [&] { return Interpreter::visit(expr); });
+}
+
+Value ProfilingInterpreter::visit(const Expression::Unary<Value>& expr) const {
+    return profile(m_unary[static_cast<std::size_t>(expr.op().getType())], expr.op().getLine(),
+                   [&] { return Interpreter::visit(expr); });
+}
+
+Value ProfilingInterpreter::visit(const Expression::Variable<Value>& expr) const {
+    return profile(m_variable, expr.name().getLine(), [&] { return Interpreter::visit(expr); });
+}
+
+void ProfilingInterpreter::report(std::ostream& out) const {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    struct Row {
+        std::string name;
+        Entry entry;
+    };
+
+    auto print{[&](std::string_view title, std::vector<Row> rows) {
+        std::sort(rows.begin(), rows.end(),
+                  [](const Row& a, const Row& b) { return a.entry.self > b.entry.self; });
+
+        std::println(out, "{:<16} {:>12} {:>12} {:>12}", title, "count", "self ms", "total ms");
+        for (const auto& row : rows) {
+            std::println(out, "{:<16} {:>12} {:>12.3f} {:>12.3f}", row.name, row.entry.count,
+                         Milliseconds{row.entry.self}.count(),
+                         Milliseconds{row.entry.total}.count());
+        }
+    }};
+
+    std::vector<Row> nodes{};
+    for (std::size_t type{0}; type < TOKEN_TYPES; ++type) {
+        std::ostringstream op{};
+        op << static_cast<TokenType>(type);
+
+        if (m_binary[type].count != 0) {
+            nodes.push_back({"Binary " + op.str(), m_binary[type]});
+        }
+        if (m_unary[type].count != 0) {
+            nodes.push_back({"Unary " + op.str(), m_unary[type]});
+        }
+    }
+    if (m_grouping.count != 0) {
+        nodes.push_back({"Grouping", m_grouping});
+    }
+    if (m_literal.count != 0) {
+        nodes.push_back({"Literal", m_literal});
+    }
+    if (m_variable.count != 0) {
+        nodes.push_back({"Variable", m_variable});
+    }
+
+    std::vector<Row> lines{};
+    for (const auto& [line, entry] : m_lines) {
+        lines.push_back({"line " + std::to_string(line), entry});
+    }
+
+    print("node", std::move(nodes));
+    print("line", std::move(lines));
+}
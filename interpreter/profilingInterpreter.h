@@ -0,0 +1,70 @@
+#ifndef PROFILING_INTERPRETER_H
+#define PROFILING_INTERPRETER_H
+
+#include "interpreter.h"
+#include "typing/tokentypes.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <ostream>
+
+/*
+ * Interpreter that counts and times every node it evaluates, per node kind (binary and unary
+ * nodes per operator) and per source line. It overrides the visits and forwards to Interpreter,
+ * so the plain Interpreter pays nothing for it: profiling is picking this class instead.
+ *
+ * Times are self times, i.e. excluding the time spent in child nodes, so they add up. Literals
+ * and groupings carry no token and are attributed to the line of the enclosing operator.
+ */
+class ProfilingInterpreter : public Interpreter {
+  public:
+    explicit ProfilingInterpreter(std::ostream& out = std::cout, std::ostream& err = std::cerr)
+        : Interpreter{out, err} {}
+
+    ProfilingInterpreter(const ProfilingInterpreter&) = delete;
+    ProfilingInterpreter& operator=(const ProfilingInterpreter&) = delete;
+
+    ProfilingInterpreter(ProfilingInterpreter&&) noexcept = delete;
+    ProfilingInterpreter& operator=(ProfilingInterpreter&&) = delete;
+
+    ~ProfilingInterpreter() = default;
+
+    Value visit(const Expression::Binary<Value>& expr) const override;
+    Value visit(const Expression::Grouping<Value>& expr) const override;
+    Value visit(const Expression::Literal<Value>& expr) const override;
+    Value visit(const Expression::Unary<Value>& expr) const override;
+    Value visit(const Expression::Variable<Value>& expr) const override;
+
+    // Both tables, sorted by self time, most expensive first.
+    void report(std::ostream& out) const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::uint64_t count{0};
+        Clock::duration self{};
+        Clock::duration total{};
+    };
+
+    static constexpr std::size_t TOKEN_TYPES{static_cast<std::size_t>(TokenType::_eof) + 1};
+
+    template <typename Visit>
+    Value profile(Entry& entry, int line, Visit visit) const;
+
+    mutable std::array<Entry, TOKEN_TYPES> m_binary{};
+    mutable std::array<Entry, TOKEN_TYPES> m_unary{};
+    mutable Entry m_grouping{};
+    mutable Entry m_literal{};
+    mutable Entry m_variable{};
+    mutable std::map<int, Entry> m_lines{};
+
+    // Time spent in the children of the node currently being evaluated.
+    mutable Clock::duration m_childTime{};
+    mutable int m_line{1};
+};
+
+#endif // PROFILING_INTERPRETER_H
@@ -0,0 +1,157 @@
+#include "assembler.h"
+#include <cassert>
+#include <cstring>
+
+namespace Jit {
+namespace {
+
+constexpr std::uint8_t REX_W{0x48};
+constexpr std::uint8_t REX{0x40};
+constexpr std::uint8_t REX_R{0x04};
+constexpr std::uint8_t REX_B{0x01};
+
+constexpr std::uint8_t MOD_DISP32{0b10};
+constexpr std::uint8_t MOD_REGISTER{0b11};
+
+constexpr std::uint8_t modRm(std::uint8_t mod, std::uint8_t reg, std::uint8_t rm) {
+    return static_cast<std::uint8_t>(mod << 6 | (reg & 7) << 3 | (rm & 7));
+}
+
+constexpr std::uint8_t index(Gpr gpr) {
+    return static_cast<std::uint8_t>(gpr);
+}
+
+} // namespace
+
+void Assembler::movabs(Gpr dst, std::uint64_t imm) {
+    byte(REX_W);
+    byte(0xb8 + index(dst));
+    for (int i{0}; i < 8; ++i) {
+        byte(static_cast<std::uint8_t>(imm >> (8 * i)));
+    }
+}
+
+void Assembler::movl(Gpr dst, std::uint32_t imm) {
+    byte(0xb8 + index(dst));
+    int32(static_cast<std::int32_t>(imm));
+}
+
+void Assembler::load(Gpr dst, Gpr base, std::int32_t disp) {
+    byte(REX_W);
+    byte(0x8b);
+    modRmDisp32(index(dst), base, disp);
+}
+
+void Assembler::store(Gpr base, std::int32_t disp, Gpr src) {
+    byte(REX_W);
+    byte(0x89);
+    modRmDisp32(index(src), base, disp);
+}
+
+void Assembler::andq(Gpr dst, Gpr src) {
+    byte(REX_W);
+    byte(0x21);
+    byte(modRm(MOD_REGISTER, index(src), index(dst)));
+}
+
+void Assembler::cmpq(Gpr dst, Gpr src) {
+    byte(REX_W);
+    byte(0x39);
+    byte(modRm(MOD_REGISTER, index(src), index(dst)));
+}
+
+void Assembler::xorl(Gpr dst, Gpr src) {
+    byte(0x31);
+    byte(modRm(MOD_REGISTER, index(src), index(dst)));
+}
+
+void Assembler::btc(Gpr dst, std::uint8_t bit) {
+    byte(REX_W);
+    byte(0x0f);
+    byte(0xba);
+    byte(modRm(MOD_REGISTER, 7, index(dst)));
+    byte(bit);
+}
+
+void Assembler::ret() {
+    byte(0xc3);
+}
+
+void Assembler::movq(Xmm dst, Gpr src) {
+    sseRegisters(0x66, 0x6e, dst, index(src), true);
+}
+
+void Assembler::movq(Gpr dst, Xmm src) {
+    sseRegisters(0x66, 0x7e, src, index(dst), true);
+}
+
+void Assembler::movsd(Xmm dst, Gpr base, std::int32_t disp) {
+    assert(dst < XMM_COUNT);
+    byte(0xf2);
+    if (dst >= 8) {
+        byte(REX | REX_R);
+    }
+    byte(0x0f);
+    byte(0x10);
+    modRmDisp32(dst, base, disp);
+}
+
+void Assembler::movapd(Xmm dst, Xmm src) {
+    sseRegisters(0x66, 0x28, dst, src, false);
+}
+
+void Assembler::sse(SseOp op, Xmm dst, Xmm src) {
+    sseRegisters(0xf2, static_cast<std::uint8_t>(op), dst, src, false);
+}
+
+void Assembler::cmpsd(Xmm dst, Xmm src, Predicate predicate) {
+    sseRegisters(0xf2, 0xc2, dst, src, false);
+    byte(static_cast<std::uint8_t>(predicate));
+}
+
+auto Assembler::jumpIfEqual() -> Label {
+    byte(0x0f);
+    byte(0x84);
+    Label label{m_code.size()};
+    int32(0);
+    return label;
+}
+
+void Assembler::bind(Label label) {
+    // rel32 counts from the end of the jump instruction, which is where the displacement ends.
+    auto target{static_cast<std::int32_t>(m_code.size() - (label + 4))};
+    std::memcpy(m_code.data() + label, &target, sizeof(target));
+}
+
+void Assembler::byte(std::uint8_t value) {
+    m_code.push_back(value);
+}
+
+void Assembler::int32(std::int32_t value) {
+    for (int i{0}; i < 4; ++i) {
+        byte(static_cast<std::uint8_t>(static_cast<std::uint32_t>(value) >> (8 * i)));
+    }
+}
+
+void Assembler::sseRegisters(std::uint8_t prefix, std::uint8_t opcode, Xmm reg, Xmm rm,
+                             bool wide) {
+    assert(reg < XMM_COUNT && rm < XMM_COUNT);
+    byte(prefix);
+    std::uint8_t rex{static_cast<std::uint8_t>((wide ? REX_W : 0) | (reg >= 8 ? REX_R : 0) |
+                                               (rm >= 8 ? REX_B : 0))};
+    if (rex != 0) {
+        byte(rex | REX);
+    }
+    byte(0x0f);
+    byte(opcode);
+    byte(modRm(MOD_REGISTER, reg, rm));
+}
+
+void Assembler::modRmDisp32(std::uint8_t reg, Gpr base, std::int32_t disp) {
+    // rsp as a base would need a SIB byte, and the JIT never addresses off the stack.
+    assert(index(base) != 4);
+    byte(modRm(MOD_DISP32, reg, index(base)));
+    int32(disp);
+}
+
+} // namespace Jit
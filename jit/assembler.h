@@ -0,0 +1,96 @@
+#ifndef ASSEMBLER_H
+#define ASSEMBLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Just enough of an x86-64 encoder for the JIT: scalar double arithmetic on xmm0-xmm15, 64-bit
+ * moves between memory, general purpose and xmm registers, and forward conditional jumps.
+ *
+ * General purpose operands are limited to the first eight registers, which is all the JIT uses,
+ * so only xmm operands ever need a REX.R or REX.B bit.
+ */
+namespace Jit {
+
+enum class Gpr : std::uint8_t {
+    _rax = 0,
+    _rcx = 1,
+    _rdx = 2,
+    _rsi = 6,
+    _rdi = 7,
+};
+
+using Xmm = std::uint8_t;
+inline constexpr Xmm XMM_COUNT{16};
+
+// Second opcode byte of the scalar double instructions, all prefixed F2 0F.
+enum class SseOp : std::uint8_t {
+    _add = 0x58,
+    _multiply = 0x59,
+    _subtract = 0x5c,
+    _divide = 0x5e,
+};
+
+// cmpsd predicates, the result is all ones when it holds and zero otherwise.
+enum class Predicate : std::uint8_t {
+    _equal = 0,
+    _less = 1,
+    _less_equal = 2,
+    _not_equal = 4, // also holds when either operand is NaN
+};
+
+class Assembler {
+  public:
+    // Position of a rel32 displacement waiting for bind().
+    using Label = std::size_t;
+
+    Assembler() = default;
+
+    Assembler(const Assembler&) = delete;
+    Assembler& operator=(const Assembler&) = delete;
+
+    Assembler(Assembler&&) noexcept = delete;
+    Assembler& operator=(Assembler&&) = delete;
+
+    ~Assembler() = default;
+
+    void movabs(Gpr dst, std::uint64_t imm);          // mov dst, imm64
+    void movl(Gpr dst, std::uint32_t imm);            // mov dst32, imm32
+    void load(Gpr dst, Gpr base, std::int32_t disp);  // mov dst, [base + disp]
+    void store(Gpr base, std::int32_t disp, Gpr src); // mov [base + disp], src
+    void andq(Gpr dst, Gpr src);
+    void cmpq(Gpr dst, Gpr src);
+    void xorl(Gpr dst, Gpr src);
+    void btc(Gpr dst, std::uint8_t bit);
+    void ret();
+
+    void movq(Xmm dst, Gpr src);
+    void movq(Gpr dst, Xmm src);
+    void movsd(Xmm dst, Gpr base, std::int32_t disp); // movsd dst, [base + disp]
+    void movapd(Xmm dst, Xmm src);
+    void sse(SseOp op, Xmm dst, Xmm src);
+    void cmpsd(Xmm dst, Xmm src, Predicate predicate);
+
+    Label jumpIfEqual();
+    // Points the jump at the current position.
+    void bind(Label label);
+
+    const std::vector<std::uint8_t>& code() const {
+        return m_code;
+    }
+
+  private:
+    void byte(std::uint8_t value);
+    void int32(std::int32_t value);
+    // 66/F2 prefix, optional REX, 0F and the opcode, then a register to register ModRM.
+    void sseRegisters(std::uint8_t prefix, std::uint8_t opcode, Xmm reg, Xmm rm, bool wide);
+    void modRmDisp32(std::uint8_t reg, Gpr base, std::int32_t disp);
+
+    std::vector<std::uint8_t> m_code;
+};
+
+} // namespace Jit
+
+#endif // ASSEMBLER_H
@@ -0,0 +1,46 @@
+#include "executableMemory.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace Jit {
+
+ExecutableMemory::ExecutableMemory(std::span<const std::uint8_t> code) {
+    auto page{static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))};
+    std::size_t size{(code.size() + page - 1) / page * page};
+
+    void* pages{::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+    if (pages == MAP_FAILED) {
+        throw std::system_error{errno, std::generic_category(), "mmap"};
+    }
+
+    std::memcpy(pages, code.data(), code.size());
+    if (::mprotect(pages, size, PROT_READ | PROT_EXEC) != 0) {
+        int error{errno};
+        ::munmap(pages, size);
+        throw std::system_error{error, std::generic_category(), "mprotect"};
+    }
+
+    m_pages = pages;
+    m_size = size;
+}
+
+ExecutableMemory::ExecutableMemory(ExecutableMemory&& other) noexcept
+    : m_pages{std::exchange(other.m_pages, nullptr)}, m_size{std::exchange(other.m_size, 0)} {}
+
+ExecutableMemory& ExecutableMemory::operator=(ExecutableMemory&& other) noexcept {
+    std::swap(m_pages, other.m_pages);
+    std::swap(m_size, other.m_size);
+    return *this;
+}
+
+ExecutableMemory::~ExecutableMemory() {
+    if (m_pages != nullptr) {
+        ::munmap(m_pages, m_size);
+    }
+}
+
+} // namespace Jit
@@ -0,0 +1,39 @@
+#ifndef EXECUTABLE_MEMORY_H
+#define EXECUTABLE_MEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Jit {
+
+/*
+ * Pages of machine code, mapped for the lifetime of the object. The pages are writable only while
+ * the code is copied in, then remapped read and execute, so no page is ever writable and
+ * executable at once.
+ */
+class ExecutableMemory {
+  public:
+    // Copies `code` into fresh pages. Throws std::system_error if the system refuses them.
+    explicit ExecutableMemory(std::span<const std::uint8_t> code);
+
+    ExecutableMemory(const ExecutableMemory&) = delete;
+    ExecutableMemory& operator=(const ExecutableMemory&) = delete;
+
+    ExecutableMemory(ExecutableMemory&& other) noexcept;
+    ExecutableMemory& operator=(ExecutableMemory&& other) noexcept;
+
+    ~ExecutableMemory();
+
+    const void* entry() const {
+        return m_pages;
+    }
+
+  private:
+    void* m_pages{nullptr};
+    std::size_t m_size{0};
+};
+
+} // namespace Jit
+
+#endif // EXECUTABLE_MEMORY_H
@@ -0,0 +1,283 @@
+#include "jitCompiler.h"
+#include "typing/tokentypes.h"
+#include <algorithm>
+#include <bit>
+#include <system_error>
+
+// The generated code follows the System V calling convention.
+#if defined(__x86_64__) && !defined(_WIN32)
+#define LOX_JIT_SUPPORTED 1
+#else
+#define LOX_JIT_SUPPORTED 0
+#endif
+
+namespace Jit {
+
+auto Function::evaluate(std::span<const Value> inputs) const -> std::optional<Value> {
+    if (inputs.size() < m_inputs) {
+        return std::nullopt;
+    }
+
+    auto entry{reinterpret_cast<Entry>(const_cast<void*>(m_code.entry()))};
+    std::uint64_t result{};
+    if (!entry(inputs.data(), &result)) {
+        return std::nullopt;
+    }
+    if (m_boolean) {
+        return Value{result != 0};
+    }
+    return Value{std::bit_cast<double>(result)};
+}
+
+/*
+ * The function is
+ *
+ *     guard:  fails unless every input it reads is a number
+ *     body:   the tree, its value ending up in xmm0
+ *     return: stores xmm0 through the result pointer
+ *
+ * with the inputs pointer in rdi and the result pointer in rsi.
+ */
+auto Compiler::compile(const Expression::Expression<Value>& expr) const -> std::optional<Function> {
+    if (!LOX_JIT_SUPPORTED) {
+        return std::nullopt;
+    }
+
+    m_nodes.clear();
+    m_unsupported = false;
+    expr.accept(*this);
+    if (m_unsupported || m_nodes.back().registers > XMM_COUNT) {
+        return std::nullopt;
+    }
+
+    Assembler assembler{};
+
+    std::vector<bool> guarded(m_inputNames.size());
+    std::vector<Assembler::Label> guardFailures{};
+    for (const Node& node : m_nodes) {
+        if (node.operation != Operation::_input || guarded[node.operand]) {
+            continue;
+        }
+        if (guardFailures.empty()) {
+            assembler.movabs(Gpr::_rdx, Value::QNAN);
+        }
+        // Value::isNumber() on the raw bits.
+        guarded[node.operand] = true;
+        assembler.load(Gpr::_rax, Gpr::_rdi, static_cast<std::int32_t>(8 * node.operand));
+        assembler.andq(Gpr::_rax, Gpr::_rdx);
+        assembler.cmpq(Gpr::_rax, Gpr::_rdx);
+        guardFailures.push_back(assembler.jumpIfEqual());
+    }
+
+    emit(assembler, m_nodes.size() - 1, 0);
+    assembler.movq(Gpr::_rax, Xmm{0});
+    assembler.store(Gpr::_rsi, 0, Gpr::_rax);
+    assembler.movl(Gpr::_rax, 1);
+    assembler.ret();
+
+    for (auto label : guardFailures) {
+        assembler.bind(label);
+    }
+    assembler.xorl(Gpr::_rax, Gpr::_rax);
+    assembler.ret();
+
+    try {
+        return Function{ExecutableMemory{assembler.code()},
+                        isComparison(m_nodes.back().operation), m_inputNames.size()};
+    } catch (const std::system_error&) {
+        // No executable pages, the interpreters still work.
+        return std::nullopt;
+    }
+}
+
+Value Compiler::visit(const Expression::Binary<Value>& expr) const {
+    expr.left().accept(*this);
+    std::size_t left{m_nodes.size() - 1};
+    if (m_unsupported) {
+        return Value{};
+    }
+    expr.right().accept(*this);
+    std::size_t right{m_nodes.size() - 1};
+    if (m_unsupported) {
+        return Value{};
+    }
+
+    // A comparison feeding anything else means booleans flowing through the tree.
+    if (isComparison(m_nodes[left].operation) || isComparison(m_nodes[right].operation)) {
+        unsupported();
+        return Value{};
+    }
+
+    switch (expr.op().getType()) {
+    case TokenType::_plus:
+        push(Operation::_add, left, right, 0);
+        break;
+    case TokenType::_minus:
+        push(Operation::_subtract, left, right, 0);
+        break;
+    case TokenType::_star:
+        push(Operation::_multiply, left, right, 0);
+        break;
+    case TokenType::_slash:
+        push(Operation::_divide, left, right, 0);
+        break;
+    case TokenType::_greater:
+        push(Operation::_greater, left, right, 0);
+        break;
+    case TokenType::_greater_equal:
+        push(Operation::_greater_equal, left, right, 0);
+        break;
+    case TokenType::_less:
+        push(Operation::_less, left, right, 0);
+        break;
+    case TokenType::_less_equal:
+        push(Operation::_less_equal, left, right, 0);
+        break;
+    case TokenType::_equal_equal:
+        push(Operation::_equal, left, right, 0);
+        break;
+    case TokenType::_bang_equal:
+        push(Operation::_not_equal, left, right, 0);
+        break;
+    default:
+        unsupported();
+        break;
+    }
+    return Value{};
+}
+
+Value Compiler::visit(const Expression::Grouping<Value>& expr) const {
+    return expr.expr().accept(*this);
+}
+
+Value Compiler::visit(const Expression::Literal<Value>& expr) const {
+    const Value& literal{expr.getLiteral()};
+    if (!literal.isNumber()) {
+        unsupported();
+        return Value{};
+    }
+    push(Operation::_constant, 0, 0, std::bit_cast<std::uint64_t>(literal.asNumber()));
+    return Value{};
+}
+
+Value Compiler::visit(const Expression::Unary<Value>& expr) const {
+    expr.right().accept(*this);
+    std::size_t right{m_nodes.size() - 1};
+    if (m_unsupported) {
+        return Value{};
+    }
+
+    // `!` only ever produces a boolean.
+    if (expr.op().getType() != TokenType::_minus || isComparison(m_nodes[right].operation)) {
+        unsupported();
+        return Value{};
+    }
+    push(Operation::_negate, right, 0, 0);
+    return Value{};
+}
+
+Value Compiler::visit(const Expression::Variable<Value>& expr) const {
+    auto name{std::find(m_inputNames.begin(), m_inputNames.end(), expr.name().getLexeme())};
+    if (name == m_inputNames.end()) {
+        // Unbound, the interpreter reports it.
+        unsupported();
+        return Value{};
+    }
+    push(Operation::_input, 0, 0, static_cast<std::uint64_t>(name - m_inputNames.begin()));
+    return Value{};
+}
+
+// Registers follow Sethi-Ullman numbering: a binary node needs one more than its operands when
+// they need the same, and the larger of the two otherwise.
+void Compiler::push(Operation operation, std::size_t left, std::size_t right,
+                    std::uint64_t operand) const {
+    std::size_t registers{1};
+    if (operation == Operation::_negate) {
+        registers = m_nodes[left].registers;
+    } else if (operation >= Operation::_add) {
+        std::size_t a{m_nodes[left].registers};
+        std::size_t b{m_nodes[right].registers};
+        registers = a == b ? a + 1 : std::max(a, b);
+    }
+    m_nodes.push_back({operation, registers, left, right, operand});
+}
+
+void Compiler::unsupported() const {
+    m_unsupported = true;
+}
+
+void Compiler::emit(Assembler& assembler, std::size_t index, Xmm target) const {
+    const Node& node{m_nodes[index]};
+
+    switch (node.operation) {
+    case Operation::_constant:
+        assembler.movabs(Gpr::_rax, node.operand);
+        assembler.movq(target, Gpr::_rax);
+        return;
+    case Operation::_input:
+        assembler.movsd(target, Gpr::_rdi, static_cast<std::int32_t>(8 * node.operand));
+        return;
+    case Operation::_negate:
+        // Flips the sign bit only, like the interpreter's negation, so NaNs and zeroes match too.
+        emit(assembler, node.left, target);
+        assembler.movq(Gpr::_rax, target);
+        assembler.btc(Gpr::_rax, 63);
+        assembler.movq(target, Gpr::_rax);
+        return;
+    default:
+        break;
+    }
+
+    // The operand needing more registers goes first, the other then has all but its result left.
+    bool leftFirst{m_nodes[node.left].registers >= m_nodes[node.right].registers};
+    Xmm left{leftFirst ? target : static_cast<Xmm>(target + 1)};
+    Xmm right{leftFirst ? static_cast<Xmm>(target + 1) : target};
+    emit(assembler, leftFirst ? node.left : node.right, target);
+    emit(assembler, leftFirst ? node.right : node.left, static_cast<Xmm>(target + 1));
+
+    // Always left op right with left as the destination, the same instruction the interpreter's
+    // `left.asNumber() op right.asNumber()` compiles to. > and >= swap their operands instead.
+    Xmm result{left};
+    switch (node.operation) {
+    case Operation::_add:
+        assembler.sse(SseOp::_add, left, right);
+        break;
+    case Operation::_subtract:
+        assembler.sse(SseOp::_subtract, left, right);
+        break;
+    case Operation::_multiply:
+        assembler.sse(SseOp::_multiply, left, right);
+        break;
+    case Operation::_divide:
+        assembler.sse(SseOp::_divide, left, right);
+        break;
+    case Operation::_greater:
+        assembler.cmpsd(right, left, Predicate::_less);
+        result = right;
+        break;
+    case Operation::_greater_equal:
+        assembler.cmpsd(right, left, Predicate::_less_equal);
+        result = right;
+        break;
+    case Operation::_less:
+        assembler.cmpsd(left, right, Predicate::_less);
+        break;
+    case Operation::_less_equal:
+        assembler.cmpsd(left, right, Predicate::_less_equal);
+        break;
+    case Operation::_equal:
+        assembler.cmpsd(left, right, Predicate::_equal);
+        break;
+    case Operation::_not_equal:
+        assembler.cmpsd(left, right, Predicate::_not_equal);
+        break;
+    default:
+        break;
+    }
+
+    if (result != target) {
+        assembler.movapd(target, result);
+    }
+}
+
+} // namespace Jit
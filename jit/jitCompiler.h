@@ -0,0 +1,131 @@
+#ifndef JIT_COMPILER_H
+#define JIT_COMPILER_H
+
+#include "assembler.h"
+#include "ast/expressionTrees.h"
+#include "executableMemory.h"
+#include "typing/types.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Jit {
+
+/*
+ * An expression compiled to native code. Immutable once built, so one function can be called from
+ * any number of threads at the same time.
+ */
+class Function {
+  public:
+    Function(const Function&) = delete;
+    Function& operator=(const Function&) = delete;
+
+    Function(Function&&) noexcept = default;
+    Function& operator=(Function&&) noexcept = default;
+
+    ~Function() = default;
+
+    /*
+     * Evaluates with inputs[i] bound to the i-th input name. Returns nothing if an input the code
+     * reads is not a number, the type guard the caller falls back to an interpreter on.
+     */
+    std::optional<Value> evaluate(std::span<const Value> inputs) const;
+
+  private:
+    friend class Compiler;
+
+    // Returns false without writing the result when the guard fails.
+    using Entry = bool (*)(const Value* inputs, std::uint64_t* result);
+
+    Function(ExecutableMemory code, bool boolean, std::size_t inputs)
+        : m_code{std::move(code)}, m_boolean{boolean}, m_inputs{inputs} {}
+
+    ExecutableMemory m_code;
+    // The result is a comparison mask, all ones for true, instead of a number.
+    bool m_boolean;
+    std::size_t m_inputs;
+};
+
+/*
+ * Lowers expressions that only ever compute with numbers into x86-64 SSE2 code: number literals,
+ * inputs, negation and arithmetic, with at most one comparison at the root. Anything else is left
+ * to the interpreters, compile() returns nothing for it.
+ *
+ * Every operation is the same IEEE operation the interpreter performs on the same operands, so the
+ * results are bit for bit identical. Operands are evaluated in whichever order needs fewer
+ * registers, which is safe because, once the guard has passed, nothing in such a tree can fail.
+ */
+class Compiler : public Expression::Visitor<Value> {
+  public:
+    explicit Compiler(std::span<const std::string_view> inputNames = {})
+        : m_inputNames{inputNames} {}
+
+    Compiler(const Compiler&) = delete;
+    Compiler& operator=(const Compiler&) = delete;
+
+    Compiler(Compiler&&) noexcept = delete;
+    Compiler& operator=(Compiler&&) = delete;
+
+    ~Compiler() = default;
+
+    // Nothing if the tree is not number-only, or there is no code generator for this platform.
+    std::optional<Function> compile(const Expression::Expression<Value>& expr) const;
+
+    Value visit(const Expression::Binary<Value>& expr) const override;
+    Value visit(const Expression::Grouping<Value>& expr) const override;
+    Value visit(const Expression::Literal<Value>& expr) const override;
+    Value visit(const Expression::Unary<Value>& expr) const override;
+    Value visit(const Expression::Variable<Value>& expr) const override;
+
+  private:
+    enum class Operation : std::uint8_t {
+        _constant,
+        _input,
+        _negate,
+
+        _add,
+        _subtract,
+        _multiply,
+        _divide,
+
+        _greater,
+        _greater_equal,
+        _less,
+        _less_equal,
+        _equal,
+        _not_equal,
+    };
+
+    // The tree is first flattened to these, in postfix order, then code is generated from them.
+    struct Node {
+        Operation operation;
+        // xmm registers needed to evaluate the subtree without spilling.
+        std::size_t registers;
+        std::size_t left;
+        std::size_t right;
+        // Bits of a constant, slot of an input.
+        std::uint64_t operand;
+    };
+
+    static bool isComparison(Operation operation) {
+        return operation >= Operation::_greater;
+    }
+
+    void push(Operation operation, std::size_t left, std::size_t right,
+              std::uint64_t operand) const;
+    void unsupported() const;
+    // Code that leaves the value of the subtree at `node` in `target`.
+    void emit(Assembler& assembler, std::size_t node, Xmm target) const;
+
+    std::span<const std::string_view> m_inputNames;
+    mutable std::vector<Node> m_nodes;
+    mutable bool m_unsupported{false};
+};
+
+} // namespace Jit
+
+#endif // JIT_COMPILER_H
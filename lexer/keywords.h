@@ -0,0 +1,110 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include "typing/tokentypes.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/*
+ * Keyword recognition through a perfect hash built at compile time. The first two characters and
+ * the length of every keyword are packed into one integer and multiplied by a seed, the top bits
+ * index a 32 slot table. The seed is searched for by the compiler so that no two keywords collide,
+ * which leaves one table load and one short compare per identifier and no allocation.
+ */
+namespace Keywords {
+
+struct Keyword {
+    std::string_view text;
+    TokenType type;
+};
+
+inline constexpr std::array<Keyword, 16> keywords{{
+    {"and", TokenType::_and},
+    {"class", TokenType::_class},
+    {"else", TokenType::_else},
+    {"false", TokenType::_false},
+    {"for", TokenType::_for},
+    {"fun", TokenType::_fun},
+    {"if", TokenType::_if},
+    {"nil", TokenType::_nil},
+    {"or", TokenType::_or},
+    {"print", TokenType::_print},
+    {"return", TokenType::_return},
+    {"super", TokenType::_super},
+    {"this", TokenType::_this},
+    {"true", TokenType::_true},
+    {"var", TokenType::_var},
+    {"while", TokenType::_while},
+}};
+
+inline constexpr std::size_t MIN_LENGTH{2};
+inline constexpr std::size_t MAX_LENGTH{6};
+inline constexpr unsigned TABLE_BITS{5};
+
+// Only valid for MIN_LENGTH <= text.size().
+constexpr std::uint32_t hash(std::string_view text, std::uint32_t seed) {
+    std::uint32_t key{static_cast<std::uint32_t>(static_cast<unsigned char>(text[0])) << 16 |
+                      static_cast<std::uint32_t>(static_cast<unsigned char>(text[1])) << 8 |
+                      static_cast<std::uint32_t>(text.size())};
+    return (key * seed) >> (32 - TABLE_BITS);
+}
+
+constexpr bool isPerfect(std::uint32_t seed) {
+    std::array<bool, 1 << TABLE_BITS> used{};
+    for (const auto& keyword : keywords) {
+        std::uint32_t slot{hash(keyword.text, seed)};
+        if (used[slot]) {
+            return false;
+        }
+        used[slot] = true;
+    }
+    return true;
+}
+
+constexpr std::uint32_t findSeed() {
+    for (std::uint32_t seed{1}; seed < (1u << 20); seed += 2) {
+        if (isPerfect(seed)) {
+            return seed;
+        }
+    }
+    return 0;
+}
+
+inline constexpr std::uint32_t SEED{findSeed()};
+static_assert(SEED != 0, "No perfect hash seed for the keyword set.");
+
+constexpr std::array<Keyword, 1 << TABLE_BITS> buildTable() {
+    std::array<Keyword, 1 << TABLE_BITS> table{};
+    for (auto& slot : table) {
+        slot = {"", TokenType::_identifier};
+    }
+    for (const auto& keyword : keywords) {
+        table[hash(keyword.text, SEED)] = keyword;
+    }
+    return table;
+}
+
+inline constexpr std::array<Keyword, 1 << TABLE_BITS> table{buildTable()};
+
+/*
+ * The keyword's token type, or TokenType::_identifier if the text is not a keyword.
+ */
+constexpr TokenType classify(std::string_view text) {
+    if (text.size() < MIN_LENGTH || text.size() > MAX_LENGTH) {
+        return TokenType::_identifier;
+    }
+
+    const Keyword& candidate{table[hash(text, SEED)]};
+    return candidate.text == text ? candidate.type : TokenType::_identifier;
+}
+
+static_assert(classify("while") == TokenType::_while);
+static_assert(classify("for") == TokenType::_for);
+static_assert(classify("fort") == TokenType::_identifier);
+static_assert(classify("x") == TokenType::_identifier);
+
+} // namespace Keywords
+
+#endif // KEYWORDS_H
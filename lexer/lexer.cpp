@@ -1,28 +1,25 @@
 #include "lexer.h"
+#include "keywords.h"
+#include "scan.h"
 #include <cctype>
-#include <optional>
-#include <stdexcept>
+#include <charconv>
 #include <string>
+#include <string_view>
+#include <system_error>
 
-Lexer::Lexer(std::string source) : m_source{source} {}
-
-const std::unordered_map<std::string, TokenType> Lexer::reservedKeywordsMap{
-    {"and", _and},   {"class", _class}, {"else", _else},   {"fun", _fun},       {"if", _if},
-    {"nil", _nil},   {"or", _or},       {"print", _print}, {"return", _return}, {"super", _super},
-    {"this", _this}, {"true", _true},   {"false", _false}, {"while", _while},   {"var", _var},
-};
+Lexer::Lexer(std::string_view source, std::ostream& out, std::ostream& err)
+    : m_source{source}, m_errorReporter{"Lexer", out, err} {}
 
 auto Lexer::advance() -> char {
     return m_source[m_current++];
 }
 
 auto Lexer::addToken(TokenType token) -> void {
-    addToken(token, std::nullopt);
+    addToken(token, Value{});
 }
 
-auto Lexer::addToken(TokenType token, Type literal) -> void {
-    std::string lexeme{m_source.substr(m_start, m_current - m_start)};
-    m_tokens.emplace_back(token, lexeme, literal, m_line);
+auto Lexer::addToken(TokenType token, Value literal) -> void {
+    m_tokens.add(token, m_start, m_current - m_start, std::move(literal));
 }
 
 auto Lexer::lexToken() -> void {
@@ -73,16 +70,9 @@ auto Lexer::lexToken() -> void {
         break;
     case '/':
         if (match('/')) {
-            while (peek() != '\n' && !isAtEnd()) {
-                advance();
-            }
+            skipTo(Scan::findLineEnd(m_source, m_current));
         } else if (match('*')) {
-            while (!isAtEnd() && !(peek() == '*' && peekTwice() == '/')) {
-                if (peek() == '\n') {
-                    ++m_line;
-                }
-                advance();
-            }
+            skipTo(Scan::findBlockCommentEnd(m_source, m_current, m_line));
 
             if (isAtEnd()) {
                 m_errorReporter.error(m_line, "Unterminated multiline comment.");
@@ -94,12 +84,14 @@ auto Lexer::lexToken() -> void {
             addToken(_slash);
         }
         break;
+    case '\n':
+        ++m_line;
+        [[fallthrough]];
     case ' ':
     case '\r':
     case '\t':
-        break;
-    case '\n':
-        ++m_line;
+        // Whitespace usually comes in runs (indentation, blank lines), eat the whole run at once.
+        skipTo(Scan::skipWhitespace(m_source, m_current, m_line));
         break;
     case '"':
         addStringToken();
@@ -119,12 +111,7 @@ auto Lexer::lexToken() -> void {
 }
 
 auto Lexer::addStringToken() -> void {
-    while (peek() != '"' && !isAtEnd()) {
-        if (peek() == '\n') {
-            ++m_line;
-        }
-        advance();
-    }
+    skipTo(Scan::findStringEnd(m_source, m_current, m_line));
 
     if (isAtEnd()) {
         m_errorReporter.error(m_line, "Unterminated string.");
@@ -133,45 +120,40 @@ auto Lexer::addStringToken() -> void {
 
     advance(); // consume the closing quotes
 
-    String literal{
+    std::string_view literal{
         m_source.substr(m_start + 1, m_current - m_start - 2)}; // string slicing syntax...
-    addToken(_string, literal);
+    addToken(_string, Value::intern(literal));
 }
 
 auto Lexer::addNumberToken() -> void {
 
-    while (std::isdigit(static_cast<unsigned char>(peek()))) {
-        advance();
-    }
+    skipTo(Scan::skipDigits(m_source, m_current));
 
     // here m_current is NO longer a digit
     if (peek() == '.' && std::isdigit(static_cast<unsigned char>(peekTwice()))) {
         advance();
 
-        while (std::isdigit(static_cast<unsigned char>(peek()))) {
-            advance();
-        }
+        skipTo(Scan::skipDigits(m_source, m_current));
     }
 
-    try {
-        Number literal{std::stod(m_source.substr(m_start, m_current - m_start))};
-        addToken(_number, literal);
-    } catch (const std::runtime_error& e) {
-        m_errorReporter.error(m_line, e.what());
+    std::string_view munched{m_source.substr(m_start, m_current - m_start)};
+    Number literal{};
+    auto result{std::from_chars(munched.data(), munched.data() + munched.size(), literal)};
+    if (result.ec != std::errc{}) {
+        m_errorReporter.error(m_line, std::make_error_code(result.ec).message());
+        return;
     }
+    addToken(_number, literal);
 }
 
 auto Lexer::addIdentifierOrKeywordToken() -> void {
-    while (std::isalpha(static_cast<unsigned char>(peek()))) {
-        advance();
-    }
+    skipTo(Scan::skipAlpha(m_source, m_current));
 
-    std::string munched{m_source.substr(m_start, m_current - m_start)};
-    if (auto search{reservedKeywordsMap.find(munched)}; search != reservedKeywordsMap.end()) {
-        addToken(search->second);
-    } else {
-        addToken(_identifier);
-    }
+    addToken(Keywords::classify(m_source.substr(m_start, m_current - m_start)));
+}
+
+auto Lexer::skipTo(std::size_t index) -> void {
+    m_current = static_cast<int>(index);
 }
 
 // Implicitly advances as well!
@@ -210,13 +192,44 @@ auto Lexer::isAtEnd() -> bool {
     return m_current >= static_cast<int>(m_source.length());
 }
 
-auto Lexer::lexTokens() -> std::vector<Token> {
+auto Lexer::lexTokens() -> TokenList {
 
     while (!isAtEnd()) {
         m_start = m_current;
         lexToken();
     }
 
-    m_tokens.emplace_back(_eof, "", std::nullopt, m_line);
-    return m_tokens;
+    m_tokens.add(_eof, m_source.size(), 0);
+    return std::move(m_tokens);
+}
+
+auto Lexer::lexRange(std::size_t begin, std::size_t end, int line) -> TokenList {
+    skipTo(begin);
+    m_line = line;
+
+    while (m_current < static_cast<int>(end)) {
+        m_start = m_current;
+        lexToken();
+    }
+    return std::move(m_tokens);
+}
+
+/*
+ * Pull interface for streaming: lexes just far enough to produce the next token, then keeps
+ * returning eof once the source is exhausted. Nothing accumulates in m_tokens.
+ */
+auto Lexer::nextToken() -> Token {
+    m_tokens.clear();
+
+    // lexToken() emits at most one token, but may emit none (whitespace, comments, errors).
+    while (m_tokens.empty() && !isAtEnd()) {
+        m_start = m_current;
+        lexToken();
+    }
+
+    if (m_tokens.empty()) {
+        return Token{_eof, "", Value{}, m_line};
+    }
+    // The lexer already knows the line here, no need for the token list's line index.
+    return Token{m_tokens.type(0), m_tokens.lexeme(0), m_tokens.literal(0), m_line};
 }
@@ -2,10 +2,13 @@
 #define LEXER_H
 
 #include "error/error.h"
+#include "tokenList.h"
 #include "typing/token.h"
 #include "typing/tokentypes.h"
+#include <iostream>
+#include <ostream>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 class Lexer {
@@ -13,25 +16,35 @@ class Lexer {
 
   public:
     Lexer() = default;
-    Lexer(std::string source);
+    // The lexer and the tokens it produces borrow the source, it must outlive both.
+    Lexer(std::string_view source, std::ostream& out = std::cout, std::ostream& err = std::cerr);
     Lexer(Lexer&&) = default;
     Lexer(const Lexer&) = default;
     Lexer& operator=(Lexer&&) = default;
     Lexer& operator=(const Lexer&) = default;
     ~Lexer() = default;
 
-    auto setSource(std::string source) -> void {
+    auto setSource(std::string_view source) -> void {
         m_source = source;
+        m_tokens = TokenList{source};
     }
-    auto lexTokens() -> std::vector<Token>;
+    auto lexTokens() -> TokenList;
+    /*
+     * Lexes the tokens starting in [begin, end), `begin` being on line `line`. A string or comment
+     * starting in the range is followed to its end, past `end` if need be. No eof token is added.
+     * This is how ParallelLexer hands one chunk of the source to each thread.
+     */
+    auto lexRange(std::size_t begin, std::size_t end, int line) -> TokenList;
+    auto nextToken() -> Token;
     auto lexToken() -> void;
     auto isAtEnd() -> bool;
     auto advance() -> char;
     auto addToken(TokenType token) -> void;
-    auto addToken(TokenType token, Type literal) -> void;
+    auto addToken(TokenType token, Value literal) -> void;
     auto addStringToken() -> void;
     auto addNumberToken() -> void;
     auto addIdentifierOrKeywordToken() -> void;
+    auto skipTo(std::size_t index) -> void;
     auto match(char expected) -> bool;
     auto peek() -> char;
     auto peekTwice() -> char;
@@ -47,11 +60,9 @@ class Lexer {
     int m_start{0};
     int m_current{0};
     int m_line{1};
-    std::string m_source;
-    std::vector<Token> m_tokens;
+    std::string_view m_source;
+    TokenList m_tokens{m_source};
     ErrorReporter m_errorReporter{"Lexer"};
-
-    static const std::unordered_map<std::string, TokenType> reservedKeywordsMap;
 };
 
 #endif // LEXER_H
@@ -0,0 +1,192 @@
+#include "parallelLexer.h"
+#include "lexer.h"
+#include "memory/allocationStats.h"
+#include "scan.h"
+#include "typing/tokentypes.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Where the lexer is at a chunk boundary: in code, or inside a string or block comment.
+enum class State : std::uint8_t {
+    _code,
+    _string,
+    _comment,
+};
+
+constexpr std::size_t STATES{3};
+
+struct Chunk {
+    std::size_t begin{0};
+    std::size_t end{0};
+
+    // Pre-scan: the state the chunk ends in, for each state it could start in.
+    std::array<State, STATES> exits{};
+    int newlines{0};
+
+    // Resolved once every chunk is pre-scanned.
+    State entry{State::_code};
+    int line{1};
+
+    TokenList tokens;
+    std::ostringstream out;
+    std::ostringstream err;
+    bool hadError{false};
+};
+
+/*
+ * Where lexing resumes when [begin, end) is entered in `state`: right after the string or comment
+ * left open, counting the newlines skipped. Nothing if it stays open up to `end`.
+ */
+std::optional<std::size_t> resume(std::string_view source, std::size_t begin, std::size_t end,
+                                  State state, int& newlines) {
+    std::string_view range{source.substr(0, end)};
+    switch (state) {
+    case State::_string: {
+        std::size_t quote{Scan::findStringEnd(range, begin, newlines)};
+        return quote < end ? std::optional{quote + 1} : std::nullopt;
+    }
+    case State::_comment: {
+        std::size_t star{Scan::findBlockCommentEnd(range, begin, newlines)};
+        return star < end ? std::optional{star + 2} : std::nullopt;
+    }
+    default:
+        return begin;
+    }
+}
+
+/*
+ * The state the lexer is in at `end` after entering [begin, end) in `state`. Only strings and
+ * comments change it, and in code every '"' and '/' starts a token, since no other token contains
+ * either. So the scan jumps from one of them to the next, building no tokens.
+ */
+State exitState(std::string_view source, std::size_t begin, std::size_t end, State state) {
+    std::string_view range{source.substr(0, end)};
+    int newlines{0};
+
+    auto at{resume(source, begin, end, state, newlines)};
+    while (at.has_value()) {
+        std::size_t i{Scan::findQuoteOrSlash(range, *at)};
+        if (i >= end) {
+            return State::_code;
+        }
+
+        if (range[i] == '"') {
+            state = State::_string;
+            at = resume(source, i + 1, end, state, newlines);
+        } else if (i + 1 < end && range[i + 1] == '/') {
+            at = Scan::findLineEnd(range, i + 2);
+        } else if (i + 1 < end && range[i + 1] == '*') {
+            state = State::_comment;
+            at = resume(source, i + 2, end, state, newlines);
+        } else {
+            at = i + 1;
+        }
+    }
+    return state;
+}
+
+// About equal chunks, all but the last ending right after a newline.
+std::vector<Chunk> split(std::string_view source, std::size_t threads, std::size_t minChunkBytes) {
+    std::size_t fits{source.size() / std::max<std::size_t>(minChunkBytes, 1)};
+    std::size_t count{std::clamp<std::size_t>(fits, 1, std::max<std::size_t>(threads, 1))};
+
+    std::vector<Chunk> chunks{};
+    chunks.reserve(count);
+    for (std::size_t i{1}, begin{0}; i <= count && begin < source.size(); ++i) {
+        std::size_t end{source.size()};
+        if (i < count) {
+            std::size_t target{std::max(begin, source.size() * i / count)};
+            std::size_t newline{Scan::findLineEnd(source, target)};
+            end = std::min(newline + 1, source.size());
+        }
+
+        Chunk& chunk{chunks.emplace_back()};
+        chunk.begin = begin;
+        chunk.end = end;
+        chunk.tokens = TokenList{source};
+        begin = end;
+    }
+    return chunks;
+}
+
+// Runs `function` on every chunk, each on its own thread, the first one on the calling thread.
+template <typename Function>
+void forEachChunk(std::vector<Chunk>& chunks, Function function) {
+    std::vector<std::jthread> threads{};
+    threads.reserve(chunks.size() - 1);
+    for (std::size_t i{1}; i < chunks.size(); ++i) {
+        threads.emplace_back([&function, &chunk = chunks[i]] { function(chunk); });
+    }
+    function(chunks.front());
+} // jthreads join here.
+
+} // namespace
+
+ParallelLexer::ParallelLexer(std::string_view source, std::size_t threads, std::ostream& out,
+                             std::ostream& err, std::size_t minChunkBytes)
+    : m_source{source}, m_threads{threads}, m_minChunkBytes{minChunkBytes}, m_out{out},
+      m_err{err} {}
+
+auto ParallelLexer::lexTokens() -> TokenList {
+    std::vector<Chunk> chunks{split(m_source, m_threads, m_minChunkBytes)};
+    if (chunks.size() < 2) {
+        Lexer lexer{m_source, m_out, m_err};
+        TokenList tokens{lexer.lexTokens()};
+        m_hadError = lexer.hadError();
+        return tokens;
+    }
+
+    forEachChunk(chunks, [this](Chunk& chunk) {
+        AllocationStats::Scope phase{Phase::_lex};
+        for (std::size_t state{0}; state < STATES; ++state) {
+            chunk.exits[state] =
+                exitState(m_source, chunk.begin, chunk.end, static_cast<State>(state));
+        }
+        chunk.newlines = static_cast<int>(std::count(m_source.begin() + chunk.begin,
+                                                     m_source.begin() + chunk.end, '\n'));
+    });
+
+    // Only a couple of steps per chunk, no need for threads.
+    for (std::size_t i{1}; i < chunks.size(); ++i) {
+        const Chunk& previous{chunks[i - 1]};
+        chunks[i].entry = previous.exits[static_cast<std::size_t>(previous.entry)];
+        chunks[i].line = previous.line + previous.newlines;
+    }
+
+    forEachChunk(chunks, [this](Chunk& chunk) {
+        AllocationStats::Scope phase{Phase::_lex};
+        int newlines{0};
+        auto begin{resume(m_source, chunk.begin, chunk.end, chunk.entry, newlines)};
+        if (!begin.has_value()) {
+            // All of it is inside a string or comment, lexed by the chunk it started in.
+            return;
+        }
+
+        Lexer lexer{m_source, chunk.out, chunk.err};
+        chunk.tokens = lexer.lexRange(*begin, chunk.end, chunk.line + newlines);
+        chunk.hadError = lexer.hadError();
+    });
+
+    std::size_t size{1};
+    for (const Chunk& chunk : chunks) {
+        size += chunk.tokens.size();
+    }
+
+    TokenList tokens{m_source};
+    tokens.reserve(size);
+    for (const Chunk& chunk : chunks) {
+        tokens.append(chunk.tokens);
+        m_out << chunk.out.view();
+        m_err << chunk.err.view();
+        m_hadError = m_hadError || chunk.hadError;
+    }
+    tokens.add(TokenType::_eof, m_source.size(), 0);
+    return tokens;
+}
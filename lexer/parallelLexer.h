@@ -0,0 +1,58 @@
+#ifndef PARALLEL_LEXER_H
+#define PARALLEL_LEXER_H
+
+#include "tokenList.h"
+#include <cstddef>
+#include <iostream>
+#include <ostream>
+#include <string_view>
+
+/*
+ * Lexes a large source on several threads, with the same tokens and the same errors, in the same
+ * order, as Lexer.
+ *
+ * The source is cut into chunks at newlines. A chunk may start inside a string or block comment
+ * though, which only the chunks before it can tell. So every thread first pre-scans its chunk
+ * three times, once per state it could start in (code, string, comment), for the state it ends
+ * in; those bytes are found with the SIMD scan kernels and no tokens are built. Chaining the
+ * results from the first chunk on gives each chunk its real starting state, and a prefix sum of
+ * the chunks' newline counts its first line. Then every thread lexes its chunk, skipping the
+ * string or comment it starts in, if any, with errors buffered per chunk. Token lists and errors
+ * are concatenated in chunk order at the end.
+ *
+ * Sources under two chunks, or a single thread, go to Lexer directly.
+ */
+class ParallelLexer {
+  public:
+    // Smaller chunks would not pay for the threads.
+    static constexpr std::size_t MIN_CHUNK_BYTES{256 * 1024};
+
+    // Like Lexer, the tokens borrow the source. Benchmarks and tests lower `minChunkBytes` to
+    // split sources that would otherwise be lexed in one piece.
+    ParallelLexer(std::string_view source, std::size_t threads, std::ostream& out = std::cout,
+                  std::ostream& err = std::cerr, std::size_t minChunkBytes = MIN_CHUNK_BYTES);
+
+    ParallelLexer(const ParallelLexer&) = delete;
+    ParallelLexer& operator=(const ParallelLexer&) = delete;
+
+    ParallelLexer(ParallelLexer&&) noexcept = delete;
+    ParallelLexer& operator=(ParallelLexer&&) = delete;
+
+    ~ParallelLexer() = default;
+
+    auto lexTokens() -> TokenList;
+
+    bool hadError() const {
+        return m_hadError;
+    };
+
+  private:
+    std::string_view m_source;
+    std::size_t m_threads;
+    std::size_t m_minChunkBytes;
+    std::ostream& m_out;
+    std::ostream& m_err;
+    bool m_hadError{false};
+};
+
+#endif // PARALLEL_LEXER_H
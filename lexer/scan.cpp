@@ -0,0 +1,114 @@
+#include "scan.h"
+#include "scanKernels.h"
+
+#if defined(__x86_64__) || defined(__SSE2__)
+#define LOX_SCAN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Scan {
+
+#ifdef LOX_SCAN_AVX2
+// Defined in scanAvx2.cpp, must only be called on CPUs with AVX2.
+const Kernels& avx2KernelsUnchecked();
+#endif
+
+namespace {
+
+#ifdef LOX_SCAN_SSE2
+struct Sse2 {
+    using Vec = __m128i;
+    static constexpr std::size_t width{16};
+    static constexpr std::uint32_t all{0xffff};
+
+    static Vec load(const char* data) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    }
+    static std::uint32_t eq(Vec v, char c) {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c))));
+    }
+    // lo <= v <= hi, unsigned: shift the range down to 0 and compare against its width.
+    static std::uint32_t inRange(Vec v, char lo, char hi) {
+        Vec shifted{_mm_sub_epi8(v, _mm_set1_epi8(lo))};
+        Vec clamped{_mm_min_epu8(shifted, _mm_set1_epi8(static_cast<char>(hi - lo)))};
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(shifted, clamped)));
+    }
+    static Vec toLower(Vec v) {
+        return _mm_or_si128(v, _mm_set1_epi8(0x20));
+    }
+};
+#endif
+
+const Kernels& selectKernels() {
+    if (const Kernels* avx2{avx2Kernels()}) {
+        return *avx2;
+    }
+    if (const Kernels* sse2{sse2Kernels()}) {
+        return *sse2;
+    }
+    return scalarKernels();
+}
+
+} // namespace
+
+const Kernels& scalarKernels() {
+    static const Kernels kernels{makeKernels<Scalar>("scalar")};
+    return kernels;
+}
+
+const Kernels* sse2Kernels() {
+#ifdef LOX_SCAN_SSE2
+    static const Kernels kernels{makeKernels<Sse2>("sse2")};
+    return &kernels;
+#else
+    return nullptr;
+#endif
+}
+
+const Kernels* avx2Kernels() {
+#ifdef LOX_SCAN_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return &avx2KernelsUnchecked();
+    }
+#endif
+    return nullptr;
+}
+
+const Kernels& activeKernels() {
+    static const Kernels& kernels{selectKernels()};
+    return kernels;
+}
+
+std::size_t skipWhitespace(std::string_view source, std::size_t from, int& newlines) {
+    return activeKernels().skipWhitespace(source.data(), from, source.size(), newlines);
+}
+
+std::size_t findStringEnd(std::string_view source, std::size_t from, int& newlines) {
+    return activeKernels().findStringEnd(source.data(), from, source.size(), newlines);
+}
+
+std::size_t findLineEnd(std::string_view source, std::size_t from) {
+    return activeKernels().findLineEnd(source.data(), from, source.size());
+}
+
+std::size_t findBlockCommentEnd(std::string_view source, std::size_t from, int& newlines) {
+    return activeKernels().findBlockCommentEnd(source.data(), from, source.size(), newlines);
+}
+
+std::size_t findQuoteOrSlash(std::string_view source, std::size_t from) {
+    return activeKernels().findQuoteOrSlash(source.data(), from, source.size());
+}
+
+std::size_t skipAlpha(std::string_view source, std::size_t from) {
+    return activeKernels().skipAlpha(source.data(), from, source.size());
+}
+
+std::size_t skipDigits(std::string_view source, std::size_t from) {
+    return activeKernels().skipDigits(source.data(), from, source.size());
+}
+
+std::string_view implementation() {
+    return activeKernels().name;
+}
+
+} // namespace Scan
@@ -0,0 +1,65 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <cstddef>
+#include <string_view>
+
+/*
+ * Bulk scanning primitives for the lexer. Each one starts at `from` and returns the index of the
+ * first byte that ends the run (or source.size()), optionally counting the newlines it stepped
+ * over. They process 16 (SSE2) or 32 (AVX2) bytes at a time; the widest implementation the CPU
+ * supports is picked once at startup, with a scalar fallback everywhere else.
+ */
+namespace Scan {
+
+// Skips ' ', '\r', '\t' and '\n'.
+std::size_t skipWhitespace(std::string_view source, std::size_t from, int& newlines);
+
+// Finds the closing '"' of a string literal.
+std::size_t findStringEnd(std::string_view source, std::size_t from, int& newlines);
+
+// Finds the '\n' ending a line comment.
+std::size_t findLineEnd(std::string_view source, std::size_t from);
+
+// Finds the '*' of the "*/" closing a block comment.
+std::size_t findBlockCommentEnd(std::string_view source, std::size_t from, int& newlines);
+
+// Finds the next '"' or '/', the only bytes a string or comment can start with.
+std::size_t findQuoteOrSlash(std::string_view source, std::size_t from);
+
+// Skips ASCII letters.
+std::size_t skipAlpha(std::string_view source, std::size_t from);
+
+// Skips ASCII digits.
+std::size_t skipDigits(std::string_view source, std::size_t from);
+
+// Name of the implementation in use, "avx2", "sse2" or "scalar".
+std::string_view implementation();
+
+/*
+ * One implementation of all the primitives above, on raw pointers. Exposed so every instruction
+ * set can be exercised and benchmarked, not just the one the CPU would pick.
+ */
+struct Kernels {
+    const char* name;
+    std::size_t (*skipWhitespace)(const char* data, std::size_t from, std::size_t size,
+                                  int& newlines);
+    std::size_t (*findStringEnd)(const char* data, std::size_t from, std::size_t size,
+                                 int& newlines);
+    std::size_t (*findLineEnd)(const char* data, std::size_t from, std::size_t size);
+    std::size_t (*findBlockCommentEnd)(const char* data, std::size_t from, std::size_t size,
+                                       int& newlines);
+    std::size_t (*findQuoteOrSlash)(const char* data, std::size_t from, std::size_t size);
+    std::size_t (*skipAlpha)(const char* data, std::size_t from, std::size_t size);
+    std::size_t (*skipDigits)(const char* data, std::size_t from, std::size_t size);
+};
+
+// The SSE2 and AVX2 variants return nullptr when not built in or not supported by this CPU.
+const Kernels& scalarKernels();
+const Kernels* sse2Kernels();
+const Kernels* avx2Kernels();
+const Kernels& activeKernels();
+
+} // namespace Scan
+
+#endif // SCAN_H
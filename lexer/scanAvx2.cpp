@@ -0,0 +1,39 @@
+// Built with -mavx2, see lexer/CMakeLists.txt. Only reached after a runtime CPU check.
+#include "scanKernels.h"
+#include <immintrin.h>
+
+namespace Scan {
+namespace {
+
+struct Avx2 {
+    using Vec = __m256i;
+    static constexpr std::size_t width{32};
+    static constexpr std::uint32_t all{0xffffffff};
+
+    static Vec load(const char* data) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    }
+    static std::uint32_t eq(Vec v, char c) {
+        return static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c))));
+    }
+    // lo <= v <= hi, unsigned: shift the range down to 0 and compare against its width.
+    static std::uint32_t inRange(Vec v, char lo, char hi) {
+        Vec shifted{_mm256_sub_epi8(v, _mm256_set1_epi8(lo))};
+        Vec clamped{_mm256_min_epu8(shifted, _mm256_set1_epi8(static_cast<char>(hi - lo)))};
+        return static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(shifted, clamped)));
+    }
+    static Vec toLower(Vec v) {
+        return _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    }
+};
+
+} // namespace
+
+const Kernels& avx2KernelsUnchecked() {
+    static const Kernels kernels{makeKernels<Avx2>("avx2")};
+    return kernels;
+}
+
+} // namespace Scan
@@ -0,0 +1,167 @@
+#ifndef SCAN_KERNELS_H
+#define SCAN_KERNELS_H
+
+/*
+ * Private to scan.cpp and scanAvx2.cpp. The scanning loops are written once against a small set of
+ * vector operations and instantiated per instruction set. Everything here has internal linkage on
+ * purpose: scanAvx2.cpp is compiled with -mavx2, and the linker must never pick its copy of a
+ * shared inline function for code that runs on CPUs without AVX2. For the same reason the bit
+ * counting uses compiler builtins rather than the inline templates from <bit>.
+ */
+
+#include "scan.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace Scan {
+namespace {
+
+// Byte at a time, also used for the tails the vector loops leave behind.
+struct Scalar {
+    using Vec = unsigned char;
+    static constexpr std::size_t width{1};
+    static constexpr std::uint32_t all{1};
+
+    static Vec load(const char* data) {
+        return static_cast<unsigned char>(*data);
+    }
+    static std::uint32_t eq(Vec v, char c) {
+        return v == static_cast<unsigned char>(c) ? 1 : 0;
+    }
+    // lo <= v <= hi
+    static std::uint32_t inRange(Vec v, char lo, char hi) {
+        return static_cast<unsigned char>(v - lo) <= static_cast<unsigned char>(hi - lo) ? 1 : 0;
+    }
+    static Vec toLower(Vec v) {
+        return v | 0x20;
+    }
+};
+
+/*
+ * Stop conditions. mask() returns one bit per byte of the block that ends the scan.
+ */
+struct WhitespaceStop {
+    template <typename Isa>
+    static std::uint32_t mask(typename Isa::Vec v) {
+        return ~(Isa::eq(v, ' ') | Isa::eq(v, '\r') | Isa::eq(v, '\t') | Isa::eq(v, '\n')) &
+               Isa::all;
+    }
+};
+
+template <char C>
+struct CharStop {
+    template <typename Isa>
+    static std::uint32_t mask(typename Isa::Vec v) {
+        return Isa::eq(v, C);
+    }
+};
+
+struct QuoteOrSlashStop {
+    template <typename Isa>
+    static std::uint32_t mask(typename Isa::Vec v) {
+        return Isa::eq(v, '"') | Isa::eq(v, '/');
+    }
+};
+
+struct AlphaStop {
+    template <typename Isa>
+    static std::uint32_t mask(typename Isa::Vec v) {
+        return ~Isa::inRange(Isa::toLower(v), 'a', 'z') & Isa::all;
+    }
+};
+
+struct DigitStop {
+    template <typename Isa>
+    static std::uint32_t mask(typename Isa::Vec v) {
+        return ~Isa::inRange(v, '0', '9') & Isa::all;
+    }
+};
+
+template <typename Isa, typename Stop>
+std::size_t scan(const char* data, std::size_t from, std::size_t size, int* newlines) {
+    std::size_t i{from};
+
+    while (i + Isa::width <= size) {
+        typename Isa::Vec block{Isa::load(data + i)};
+        std::uint32_t stop{Stop::template mask<Isa>(block)};
+        std::uint32_t lines{newlines != nullptr ? Isa::eq(block, '\n') : 0};
+
+        if (stop != 0) {
+            unsigned offset{static_cast<unsigned>(__builtin_ctz(stop))};
+            if (newlines != nullptr) {
+                *newlines += __builtin_popcount(lines & ((std::uint32_t{1} << offset) - 1));
+            }
+            return i + offset;
+        }
+
+        if (newlines != nullptr) {
+            *newlines += __builtin_popcount(lines);
+        }
+        i += Isa::width;
+    }
+
+    if constexpr (Isa::width > 1) {
+        return scan<Scalar, Stop>(data, i, size, newlines);
+    } else {
+        return size;
+    }
+}
+
+template <typename Isa>
+std::size_t skipWhitespace(const char* data, std::size_t from, std::size_t size, int& newlines) {
+    return scan<Isa, WhitespaceStop>(data, from, size, &newlines);
+}
+
+template <typename Isa>
+std::size_t findStringEnd(const char* data, std::size_t from, std::size_t size, int& newlines) {
+    return scan<Isa, CharStop<'"'>>(data, from, size, &newlines);
+}
+
+template <typename Isa>
+std::size_t findLineEnd(const char* data, std::size_t from, std::size_t size) {
+    return scan<Isa, CharStop<'\n'>>(data, from, size, nullptr);
+}
+
+template <typename Isa>
+std::size_t findBlockCommentEnd(const char* data, std::size_t from, std::size_t size,
+                                int& newlines) {
+    while (true) {
+        std::size_t star{scan<Isa, CharStop<'*'>>(data, from, size, &newlines)};
+        if (star >= size || (star + 1 < size && data[star + 1] == '/')) {
+            return star;
+        }
+        from = star + 1;
+    }
+}
+
+template <typename Isa>
+std::size_t findQuoteOrSlash(const char* data, std::size_t from, std::size_t size) {
+    return scan<Isa, QuoteOrSlashStop>(data, from, size, nullptr);
+}
+
+template <typename Isa>
+std::size_t skipAlpha(const char* data, std::size_t from, std::size_t size) {
+    return scan<Isa, AlphaStop>(data, from, size, nullptr);
+}
+
+template <typename Isa>
+std::size_t skipDigits(const char* data, std::size_t from, std::size_t size) {
+    return scan<Isa, DigitStop>(data, from, size, nullptr);
+}
+
+template <typename Isa>
+Kernels makeKernels(const char* name) {
+    return Kernels{name,
+                   &skipWhitespace<Isa>,
+                   &findStringEnd<Isa>,
+                   &findLineEnd<Isa>,
+                   &findBlockCommentEnd<Isa>,
+                   &findQuoteOrSlash<Isa>,
+                   &skipAlpha<Isa>,
+                   &skipDigits<Isa>};
+}
+
+} // namespace
+} // namespace Scan
+
+#endif // SCAN_KERNELS_H
@@ -0,0 +1,40 @@
+#include "tokenList.h"
+#include "scan.h"
+#include <algorithm>
+
+void TokenList::append(const TokenList& other) {
+    assert(other.m_source.data() == m_source.data() && "Token lists over different sources.");
+
+    m_types.insert(m_types.end(), other.m_types.begin(), other.m_types.end());
+    m_offsets.insert(m_offsets.end(), other.m_offsets.begin(), other.m_offsets.end());
+    m_lengths.insert(m_lengths.end(), other.m_lengths.begin(), other.m_lengths.end());
+
+    // The other list's literals go after ours, so do the indices pointing at them.
+    auto base{static_cast<std::uint32_t>(m_literals.size())};
+    for (std::uint32_t slot : other.m_literalIndices) {
+        m_literalIndices.push_back(slot == NO_LITERAL ? NO_LITERAL : base + slot);
+    }
+    m_literals.insert(m_literals.end(), other.m_literals.begin(), other.m_literals.end());
+}
+
+void TokenList::indexLines() const {
+    if (m_linesIndexed) {
+        return;
+    }
+
+    for (std::size_t at{Scan::findLineEnd(m_source, 0)}; at < m_source.size();
+         at = Scan::findLineEnd(m_source, at + 1)) {
+        m_newlines.push_back(static_cast<std::uint32_t>(at));
+    }
+    m_linesIndexed = true;
+}
+
+int TokenList::line(Index index) const {
+    assert(index < size() && "Out of bounds access.");
+    indexLines();
+
+    // 1 + the number of newlines before the end of the token.
+    std::uint32_t end{m_offsets[index] + m_lengths[index]};
+    auto newlinesBefore{std::lower_bound(m_newlines.begin(), m_newlines.end(), end)};
+    return 1 + static_cast<int>(newlinesBefore - m_newlines.begin());
+}
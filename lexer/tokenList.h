@@ -0,0 +1,118 @@
+#ifndef TOKEN_LIST_H
+#define TOKEN_LIST_H
+
+#include "typing/token.h"
+#include "typing/tokentypes.h"
+#include "typing/value.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+/*
+ * Compact, struct-of-arrays storage for a lexed script. Each token costs its type, source offset,
+ * length and a literal index (13 bytes); only number and string tokens have an entry in the
+ * literal side table, and line numbers are derived from a newline index that is built the first
+ * time a line is asked for. Full Token objects are only materialized on request, for AST nodes
+ * and diagnostics.
+ *
+ * The list borrows the source. Building the line index is not thread-safe, call indexLines() first
+ * if several threads will read lines from the same list.
+ */
+class TokenList {
+  public:
+    using Index = std::uint32_t;
+
+    TokenList() = default;
+    explicit TokenList(std::string_view source) : m_source{source} {}
+
+    void add(TokenType type, std::size_t offset, std::size_t length, Value literal = {}) {
+        assert(offset + length <= std::numeric_limits<std::uint32_t>::max() &&
+               "Source too large for 32-bit offsets.");
+
+        m_types.push_back(type);
+        m_offsets.push_back(static_cast<std::uint32_t>(offset));
+        m_lengths.push_back(static_cast<std::uint32_t>(length));
+
+        if (literal.isNil()) {
+            m_literalIndices.push_back(NO_LITERAL);
+        } else {
+            m_literalIndices.push_back(static_cast<std::uint32_t>(m_literals.size()));
+            m_literals.push_back(std::move(literal));
+        }
+    }
+
+    void reserve(std::size_t tokens) {
+        m_types.reserve(tokens);
+        m_offsets.reserve(tokens);
+        m_lengths.reserve(tokens);
+        m_literalIndices.reserve(tokens);
+    }
+
+    // Appends the tokens of a list over the same source, as if they had been added to this one.
+    void append(const TokenList& other);
+
+    void clear() {
+        m_types.clear();
+        m_offsets.clear();
+        m_lengths.clear();
+        m_literalIndices.clear();
+        m_literals.clear();
+    }
+
+    std::size_t size() const {
+        return m_types.size();
+    }
+
+    bool empty() const {
+        return m_types.empty();
+    }
+
+    TokenType type(Index index) const {
+        assert(index < size() && "Out of bounds access.");
+        return m_types[index];
+    }
+
+    std::string_view lexeme(Index index) const {
+        assert(index < size() && "Out of bounds access.");
+        return m_source.substr(m_offsets[index], m_lengths[index]);
+    }
+
+    const Value& literal(Index index) const {
+        assert(index < size() && "Out of bounds access.");
+        static const Value nil{};
+        std::uint32_t slot{m_literalIndices[index]};
+        return slot == NO_LITERAL ? nil : m_literals[slot];
+    }
+
+    /*
+     * Line the token ends on, which is what the lexer reports for it: multi-line strings belong
+     * to their last line.
+     */
+    int line(Index index) const;
+
+    Token token(Index index) const {
+        return Token{type(index), lexeme(index), literal(index), line(index)};
+    }
+
+    void indexLines() const;
+
+  private:
+    static constexpr std::uint32_t NO_LITERAL{std::numeric_limits<std::uint32_t>::max()};
+
+    std::string_view m_source;
+
+    std::vector<TokenType> m_types;
+    std::vector<std::uint32_t> m_offsets;
+    std::vector<std::uint32_t> m_lengths;
+    std::vector<std::uint32_t> m_literalIndices;
+    std::vector<Value> m_literals;
+
+    // Offsets of every '\n' in the source, filled by indexLines().
+    mutable std::vector<std::uint32_t> m_newlines;
+    mutable bool m_linesIndexed{false};
+};
+
+#endif // TOKEN_LIST_H
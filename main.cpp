@@ -1,72 +1,199 @@
-#include "./interpreter/interpreter.h"
-#include "./lexer/lexer.h"
-#include "./parser/parser.h"
-#include "typing/types.h"
+#include "./driver/batch.h"
+#include "./driver/session.h"
+#include "./memory/allocationStats.h"
+#include "./output/outputSink.h"
+#include "./source/sourceBuffer.h"
+#include "./vm/bytecodeCache.h"
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
 #include <cstdlib>
-#include <fstream>
+#include <filesystem>
 #include <iostream>
+#include <optional>
+#include <ostream>
 #include <print>
-#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
-void run(std::string);
-void runFile(const std::string& path);
-void runPrompt();
+int runFile(const std::string& path, Options options, std::ostream& out, std::ostream& err);
+int runBatch(const std::filesystem::path& directory, Options options, std::size_t jobs,
+             std::ostream& out, std::ostream& err);
+void runPrompt(Options options, std::ostream& out, std::ostream& err);
 
-static Interpreter interpreter;
+namespace {
 
-int main(int argc, char* argv[]) {
-    if (argc > 2) {
-        std::println("Usage: cpplox [script]");
-    } else if (argc == 2) {
-        runFile(argv[1]);
-    } else {
-        runPrompt();
+std::optional<std::size_t> parseJobs(std::string_view text) {
+    std::size_t jobs{};
+    auto result{std::from_chars(text.data(), text.data() + text.size(), jobs)};
+    if (result.ec != std::errc{} || result.ptr != text.data() + text.size() || jobs == 0) {
+        return std::nullopt;
     }
-
-    return 0;
+    return jobs;
 }
 
-void run(std::string source) {
-    Lexer lexer{source};
-    auto tokens{lexer.lexTokens()};
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // All output is buffered and written when a buffer fills, at exit, and before reading from an
+    // interactive stdin. err is tied to out, so results already printed always come out before an
+    // error.
+    FdSink outSink{STDOUT_FILENO};
+    FdSink errSink{STDERR_FILENO, 4 * 1024};
+    std::ostream out{&outSink};
+    std::ostream err{&errSink};
+    err.tie(&out);
+    err.setf(std::ios::unitbuf);
+    std::cin.tie(::isatty(STDIN_FILENO) ? &out : nullptr);
+
+    Options options{};
+    std::optional<std::string> script{};
+    std::optional<std::string> batch{};
+    std::size_t jobs{std::max(1u, std::thread::hardware_concurrency())};
+    bool cacheStats{false};
+    bool allocationStats{false};
+    bool badUsage{false};
+
+    for (int i{1}; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+
+        if (arg == "--engine=tree") {
+            options.engine = Engine::_tree;
+        } else if (arg == "--engine=flat") {
+            options.engine = Engine::_flat;
+        } else if (arg == "--engine=vm") {
+            options.engine = Engine::_vm;
+        } else if (arg == "--engine=closure") {
+            options.engine = Engine::_closure;
+        } else if (arg == "--program") {
+            options.program = true;
+        } else if (arg == "--stream") {
+            options.streaming = true;
+        } else if (arg == "-O") {
+            options.optimize = true;
+        } else if (arg == "--jit") {
+            options.jit = true;
+        } else if (arg == "--profile") {
+            options.profile = true;
+        } else if (arg == "--no-cache") {
+            options.cache = false;
+        } else if (arg == "--cache-stats") {
+            cacheStats = true;
+        } else if (arg == "--stats") {
+            allocationStats = true;
+        } else if (arg == "--batch" && i + 1 < argc && !batch.has_value()) {
+            batch = argv[++i];
+        } else if (arg.starts_with("-j")) {
+            // Both "-j 8" and "-j8".
+            std::string_view count{arg.substr(2)};
+            if (count.empty() && i + 1 < argc) {
+                count = argv[++i];
+            }
+            auto parsed{parseJobs(count)};
+            badUsage = badUsage || !parsed.has_value();
+            jobs = parsed.value_or(jobs);
+        } else if (!arg.starts_with("--") && !script.has_value()) {
+            script = arg;
+        } else {
+            badUsage = true;
+        }
+    }
+
+    if (badUsage || (batch.has_value() && script.has_value())) {
+        std::println(out, "Usage: cpplox [options] [-j N] [script | -]");
+        std::println(out, "       cpplox [options] --batch dir [-j N]");
+        std::println(out, "Options: --engine=tree|flat|vm|closure --program --stream -O --jit "
+                     "--profile --no-cache --cache-stats --stats");
+        return 0;
+    }
 
-    Parser<Type> parser{tokens};
-    auto expression{parser.parse()};
+    // Said once here rather than by every session, a batch runs one per script.
+    if (options.program && (options.engine != Engine::_tree || options.optimize || options.jit)) {
+        std::println(err, "Programs only run on the tree engine, without -O or --jit.");
+    }
 
-    if (lexer.hadError() || parser.hadError()) {
-        return;
+    int status{EXIT_SUCCESS};
+    if (batch.has_value()) {
+        status = runBatch(batch.value(), options, jobs, out, err);
+    } else if (script.has_value()) {
+        // One script, so the jobs go to lexing and parsing it.
+        options.threads = jobs;
+        status = runFile(script.value(), options, out, err);
+    } else {
+        runPrompt(options, out, err);
     }
 
-    interpreter.interpret(*expression);
+    if (cacheStats) {
+        const auto& cache{BytecodeCache::global()};
+        std::println(err, "Bytecode cache: {} hits, {} misses.", cache.hits(),
+                     cache.misses());
+    }
+    if (allocationStats) {
+        AllocationStats::report(err);
+    }
+    return status;
 }
 
 // File script mode.
-void runFile(const std::string& path) {
-    std::ifstream file{path};
-
-    std::stringstream buffer{};
-    buffer << file.rdbuf();
+// The buffer stays alive until the run is over, everything downstream only borrows from it.
+int runFile(const std::string& path, Options options, std::ostream& out, std::ostream& err) {
+    std::optional<SourceBuffer> source{};
+    try {
+        source.emplace(SourceBuffer::fromFile(path));
+    } catch (const std::system_error& e) {
+        std::println(err, "Could not read script: {}", e.what());
+        return EXIT_FAILURE;
+    }
 
-    run(buffer.str());
+    Session session{options, out, err};
+    session.run(source->view());
+    session.printProfile();
+    return session.exitStatus();
+}
 
-    if (interpreter.hadError()) {
-        std::exit(EXIT_FAILURE);
+// Batch mode.
+// Every script runs in isolation, output is replayed in path order once all of them are done.
+int runBatch(const std::filesystem::path& directory, Options options, std::size_t jobs,
+             std::ostream& out, std::ostream& err) {
+    std::vector<std::filesystem::path> scripts{};
+    try {
+        scripts = collectScripts(directory);
+    } catch (const std::filesystem::filesystem_error& e) {
+        std::println(err, "Could not read batch directory: {}", e.what());
+        return EXIT_FAILURE;
     }
 
-    if (interpreter.hadRuntimeError()) {
-        std::exit(EXIT_FAILURE);
+    std::size_t failed{0};
+    for (const auto& result : runBatch(scripts, options, jobs)) {
+        std::println(out, "==> {} (exit {}) <==", result.path.string(), result.exitStatus);
+        out << result.out;
+        err << result.err;
+        failed += result.exitStatus != EXIT_SUCCESS;
     }
+
+    std::println(out, "{} scripts, {} failed.", scripts.size(), failed);
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 // REPL mode.
-void runPrompt() {
+// On a terminal, reading the next line flushes out through the tie on std::cin, so every result
+// shows up before the next prompt.
+void runPrompt(Options options, std::ostream& out, std::ostream& err) {
+    // Every line would leave an entry behind, and a REPL line is seldom typed twice.
+    options.cache = false;
+    Session session{options, out, err};
     std::string line{};
     while (true) {
-        std::print("> ");
+        std::print(out, "> ");
         std::getline(std::cin, line);
         if (line.empty()) {
             break;
         }
-        run(line);
+        session.run(line);
     }
+    session.printProfile();
 }
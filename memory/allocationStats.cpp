@@ -0,0 +1,217 @@
+#include "allocationStats.h"
+#include <atomic>
+#include <print>
+#include <string_view>
+
+#if LOX_ALLOC_STATS
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace {
+
+// Constant initialized, so reading it from operator new needs no TLS guard.
+thread_local Phase t_phase{Phase::_other};
+
+struct Tally {
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> peakLiveBytes{0};
+};
+
+std::array<Tally, AllocationStats::PHASES> g_tallies{};
+std::atomic<std::uint64_t> g_liveBytes{0};
+
+constexpr std::array<std::string_view, AllocationStats::PHASES> PHASE_NAMES{"other", "lex",
+                                                                            "parse", "evaluate"};
+
+} // namespace
+
+AllocationStats::Scope::Scope(Phase phase) : m_previous{t_phase} {
+    t_phase = phase;
+}
+
+AllocationStats::Scope::~Scope() {
+    t_phase = m_previous;
+}
+
+auto AllocationStats::counters(Phase phase) -> Counters {
+    const Tally& tally{g_tallies[static_cast<std::size_t>(phase)]};
+    return {tally.allocations.load(std::memory_order_relaxed),
+            tally.bytes.load(std::memory_order_relaxed),
+            tally.peakLiveBytes.load(std::memory_order_relaxed)};
+}
+
+std::uint64_t AllocationStats::liveBytes() {
+    return g_liveBytes.load(std::memory_order_relaxed);
+}
+
+void AllocationStats::reset() {
+    for (Tally& tally : g_tallies) {
+        tally.allocations.store(0, std::memory_order_relaxed);
+        tally.bytes.store(0, std::memory_order_relaxed);
+        tally.peakLiveBytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+void AllocationStats::report(std::ostream& out) {
+    if (!enabled()) {
+        std::println(out, "Allocation stats need a build configured with -DLOX_ALLOC_STATS=ON.");
+        return;
+    }
+
+    std::println(out, "Allocations by phase:");
+    for (std::size_t i{0}; i < PHASES; ++i) {
+        Counters phase{counters(static_cast<Phase>(i))};
+        std::println(out, "  {:<9} {:>10} allocations {:>12} bytes {:>12} peak live bytes",
+                     PHASE_NAMES[i], phase.allocations, phase.bytes, phase.peakLiveBytes);
+    }
+}
+
+#if LOX_ALLOC_STATS
+
+/*
+ * Every block starts with a header holding its size, so delete can take it off the live bytes
+ * without relying on sized deallocation. The header is padded to the block's alignment, which
+ * keeps the pointer handed out aligned.
+ */
+namespace {
+
+constexpr std::size_t DEFAULT_ALIGNMENT{__STDCPP_DEFAULT_NEW_ALIGNMENT__};
+
+std::size_t headerSize(std::size_t alignment) {
+    return std::max(alignment, DEFAULT_ALIGNMENT);
+}
+
+void record(std::size_t size) {
+    Tally& tally{g_tallies[static_cast<std::size_t>(t_phase)]};
+    tally.allocations.fetch_add(1, std::memory_order_relaxed);
+    tally.bytes.fetch_add(size, std::memory_order_relaxed);
+
+    std::uint64_t live{g_liveBytes.fetch_add(size, std::memory_order_relaxed) + size};
+    std::uint64_t peak{tally.peakLiveBytes.load(std::memory_order_relaxed)};
+    while (live > peak &&
+           !tally.peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void* tryAllocate(std::size_t size, std::size_t alignment) noexcept {
+    std::size_t header{headerSize(alignment)};
+    std::size_t total{header + size};
+    void* block{};
+    if (alignment > DEFAULT_ALIGNMENT) {
+        // aligned_alloc wants a multiple of the alignment.
+        block = std::aligned_alloc(alignment, (total + alignment - 1) / alignment * alignment);
+    } else {
+        block = std::malloc(total);
+    }
+    if (block == nullptr) {
+        return nullptr;
+    }
+
+    auto* user{static_cast<unsigned char*>(block) + header};
+    reinterpret_cast<std::size_t*>(user)[-1] = size;
+    record(size);
+    return user;
+}
+
+void* allocate(std::size_t size, std::size_t alignment) {
+    while (true) {
+        if (void* user{tryAllocate(size, alignment)}) {
+            return user;
+        }
+        std::new_handler handler{std::get_new_handler()};
+        if (handler == nullptr) {
+            throw std::bad_alloc{};
+        }
+        handler();
+    }
+}
+
+void release(void* user, std::size_t alignment) noexcept {
+    if (user == nullptr) {
+        return;
+    }
+    std::size_t size{static_cast<std::size_t*>(user)[-1]};
+    g_liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    std::free(static_cast<unsigned char*>(user) - headerSize(alignment));
+}
+
+void* allocateNothrow(std::size_t size, std::size_t alignment) noexcept {
+    try {
+        return allocate(size, alignment);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+auto alignment(std::align_val_t value) {
+    return static_cast<std::size_t>(value);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    return allocate(size, DEFAULT_ALIGNMENT);
+}
+void* operator new[](std::size_t size) {
+    return allocate(size, DEFAULT_ALIGNMENT);
+}
+void* operator new(std::size_t size, std::align_val_t align) {
+    return allocate(size, alignment(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return allocate(size, alignment(align));
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocateNothrow(size, DEFAULT_ALIGNMENT);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocateNothrow(size, DEFAULT_ALIGNMENT);
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocateNothrow(size, alignment(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocateNothrow(size, alignment(align));
+}
+
+void operator delete(void* user) noexcept {
+    release(user, DEFAULT_ALIGNMENT);
+}
+void operator delete[](void* user) noexcept {
+    release(user, DEFAULT_ALIGNMENT);
+}
+void operator delete(void* user, std::size_t) noexcept {
+    release(user, DEFAULT_ALIGNMENT);
+}
+void operator delete[](void* user, std::size_t) noexcept {
+    release(user, DEFAULT_ALIGNMENT);
+}
+void operator delete(void* user, std::align_val_t align) noexcept {
+    release(user, alignment(align));
+}
+void operator delete[](void* user, std::align_val_t align) noexcept {
+    release(user, alignment(align));
+}
+void operator delete(void* user, std::size_t, std::align_val_t align) noexcept {
+    release(user, alignment(align));
+}
+void operator delete[](void* user, std::size_t, std::align_val_t align) noexcept {
+    release(user, alignment(align));
+}
+void operator delete(void* user, const std::nothrow_t&) noexcept {
+    release(user, DEFAULT_ALIGNMENT);
+}
+void operator delete[](void* user, const std::nothrow_t&) noexcept {
+    release(user, DEFAULT_ALIGNMENT);
+}
+void operator delete(void* user, std::align_val_t align, const std::nothrow_t&) noexcept {
+    release(user, alignment(align));
+}
+void operator delete[](void* user, std::align_val_t align, const std::nothrow_t&) noexcept {
+    release(user, alignment(align));
+}
+
+#endif // LOX_ALLOC_STATS
@@ -0,0 +1,69 @@
+#ifndef ALLOCATION_STATS_H
+#define ALLOCATION_STATS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#ifndef LOX_ALLOC_STATS
+#define LOX_ALLOC_STATS 0
+#endif
+
+/*
+ * Heap allocation counters, per phase of a run. Only a build configured with
+ * -DLOX_ALLOC_STATS=ON counts anything: it replaces the global operator new and delete with
+ * versions that tally every allocation against the phase the allocating thread is in. In any
+ * other build the counters stay at zero.
+ *
+ * Live bytes are process wide: the peak of a phase is the most memory live in the whole process
+ * right after one of its allocations, whichever phases allocated the rest.
+ */
+enum class Phase : std::uint8_t {
+    _other,
+    _lex,
+    _parse,
+    _evaluate,
+};
+
+class AllocationStats {
+  public:
+    static constexpr std::size_t PHASES{4};
+
+    struct Counters {
+        std::uint64_t allocations{0};
+        std::uint64_t bytes{0};
+        std::uint64_t peakLiveBytes{0};
+    };
+
+    // Attributes the allocations of the current thread to `phase` until the scope ends.
+    class Scope {
+      public:
+        explicit Scope(Phase phase);
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        Scope(Scope&&) noexcept = delete;
+        Scope& operator=(Scope&&) = delete;
+
+        ~Scope();
+
+      private:
+        Phase m_previous;
+    };
+
+    static constexpr bool enabled() {
+        return LOX_ALLOC_STATS != 0;
+    }
+
+    static Counters counters(Phase phase);
+    static std::uint64_t liveBytes();
+    // Zeroes every phase. Live bytes are kept, they are still live.
+    static void reset();
+
+    // The --stats report, one line per phase.
+    static void report(std::ostream& out);
+};
+
+#endif // ALLOCATION_STATS_H
@@ -0,0 +1,87 @@
+#include "outputSink.h"
+#include <cerrno>
+#include <unistd.h>
+#include <utility>
+
+FdSink::FdSink(int fd, std::size_t capacity) : m_fd{fd}, m_buffer(capacity) {
+    setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+}
+
+FdSink::~FdSink() {
+    drain();
+}
+
+auto FdSink::overflow(int_type ch) -> int_type {
+    if (!drain()) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+auto FdSink::xsputn(const char* chars, std::streamsize count) -> std::streamsize {
+    auto size{static_cast<std::size_t>(count)};
+    auto room{static_cast<std::size_t>(epptr() - pptr())};
+    if (size <= room) {
+        traits_type::copy(pptr(), chars, size);
+        pbump(static_cast<int>(size));
+        return count;
+    }
+
+    // Too big for what is left: flush, then either buffer it or, if it would not fit even in an
+    // empty buffer, write it straight through.
+    if (!drain()) {
+        return 0;
+    }
+    if (size < m_buffer.size()) {
+        traits_type::copy(pptr(), chars, size);
+        pbump(static_cast<int>(size));
+        return count;
+    }
+    return writeAll(chars, size) ? count : 0;
+}
+
+auto FdSink::sync() -> int {
+    return drain() ? 0 : -1;
+}
+
+auto FdSink::drain() -> bool {
+    auto pending{static_cast<std::size_t>(pptr() - pbase())};
+    bool written{writeAll(pbase(), pending)};
+    setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+    return written;
+}
+
+auto FdSink::writeAll(const char* chars, std::size_t count) -> bool {
+    while (count > 0) {
+        ssize_t written{::write(m_fd, chars, count)};
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        chars += written;
+        count -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+auto CaptureSink::take() -> std::string {
+    return std::exchange(m_text, {});
+}
+
+auto CaptureSink::overflow(int_type ch) -> int_type {
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        m_text.push_back(traits_type::to_char_type(ch));
+    }
+    return traits_type::not_eof(ch);
+}
+
+auto CaptureSink::xsputn(const char* chars, std::streamsize count) -> std::streamsize {
+    m_text.append(chars, static_cast<std::size_t>(count));
+    return count;
+}
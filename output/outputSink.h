@@ -0,0 +1,82 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <cstddef>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Stream buffers that everything printing results or diagnostics ends up writing through. Wrap
+ * one in a std::ostream and hand that to a Session (or any component taking out/err streams).
+ */
+
+/*
+ * Collects output in a large user-space buffer and writes it to a file descriptor only when the
+ * buffer fills, when the stream is flushed, or when the sink is destroyed. The descriptor is
+ * borrowed, never closed.
+ *
+ * To keep two sinks in order (stdout and stderr), tie the error stream to the output stream:
+ * anything pending on `out` is then written before each error.
+ */
+class FdSink : public std::streambuf {
+  public:
+    static constexpr std::size_t DEFAULT_CAPACITY{64 * 1024};
+
+    explicit FdSink(int fd, std::size_t capacity = DEFAULT_CAPACITY);
+
+    FdSink(const FdSink&) = delete;
+    FdSink& operator=(const FdSink&) = delete;
+
+    FdSink(FdSink&&) = delete;
+    FdSink& operator=(FdSink&&) = delete;
+
+    ~FdSink() override;
+
+  protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* chars, std::streamsize count) override;
+    int sync() override;
+
+  private:
+    // Writes out everything buffered so far, false if the descriptor refused it.
+    bool drain();
+    bool writeAll(const char* chars, std::size_t count);
+
+    int m_fd;
+    std::vector<char> m_buffer;
+};
+
+/*
+ * Keeps everything written to it in memory, for embedding the interpreter or running scripts
+ * whose output is replayed later.
+ */
+class CaptureSink : public std::streambuf {
+  public:
+    CaptureSink() = default;
+
+    CaptureSink(const CaptureSink&) = delete;
+    CaptureSink& operator=(const CaptureSink&) = delete;
+
+    CaptureSink(CaptureSink&&) = delete;
+    CaptureSink& operator=(CaptureSink&&) = delete;
+
+    ~CaptureSink() override = default;
+
+    std::string_view view() const {
+        return m_text;
+    }
+
+    // Hands over what was captured so far and starts over empty.
+    std::string take();
+
+  protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* chars, std::streamsize count) override;
+
+  private:
+    std::string m_text;
+};
+
+#endif // OUTPUT_SINK_H
@@ -0,0 +1,133 @@
+#include "flatParser.h"
+#include <exception>
+#include <print>
+
+auto FlatParser::parse() -> std::optional<Flat::Ast> {
+    try {
+        Flat::NodeIndex root{expression()};
+        if (m_parseError.has_value()) {
+            std::println(m_errorReporter.err(), "Parse error caught at top level parse(): {}",
+                         m_parseError.value());
+            return std::nullopt;
+        }
+        m_ast.setRoot(root);
+        return std::move(m_ast);
+    } catch (const std::exception& e) {
+        std::println(m_errorReporter.err(), "Unknown error caught at top level parse(): {}",
+                     e.what());
+        return std::nullopt;
+    }
+}
+
+// Every rule returns NO_NODE once an error has been reported, and passes it straight up.
+auto FlatParser::expression() -> Flat::NodeIndex {
+    return equality();
+}
+
+auto FlatParser::equality() -> Flat::NodeIndex {
+    auto expr = comparison();
+
+    while (expr != Flat::NO_NODE && match({TokenType::_bang_equal, TokenType::_equal_equal})) {
+        Flat::TokenIndex oper{previousIndex()};
+        auto right = comparison();
+        if (right == Flat::NO_NODE) {
+            return Flat::NO_NODE;
+        }
+        expr = binary(expr, oper, right);
+    }
+
+    return expr;
+}
+
+auto FlatParser::comparison() -> Flat::NodeIndex {
+    auto expr = term();
+
+    while (expr != Flat::NO_NODE &&
+           match({TokenType::_greater, TokenType::_greater_equal, TokenType::_less,
+                  TokenType::_less_equal})) {
+        Flat::TokenIndex oper{previousIndex()};
+        auto right = term();
+        if (right == Flat::NO_NODE) {
+            return Flat::NO_NODE;
+        }
+        expr = binary(expr, oper, right);
+    }
+
+    return expr;
+}
+
+auto FlatParser::term() -> Flat::NodeIndex {
+    auto expr = factor();
+
+    while (expr != Flat::NO_NODE && match({TokenType::_minus, TokenType::_plus})) {
+        Flat::TokenIndex oper{previousIndex()};
+        auto right = factor();
+        if (right == Flat::NO_NODE) {
+            return Flat::NO_NODE;
+        }
+        expr = binary(expr, oper, right);
+    }
+
+    return expr;
+}
+
+auto FlatParser::factor() -> Flat::NodeIndex {
+    auto expr = unary();
+
+    while (expr != Flat::NO_NODE && match({TokenType::_slash, TokenType::_star})) {
+        Flat::TokenIndex oper{previousIndex()};
+        auto right = unary();
+        if (right == Flat::NO_NODE) {
+            return Flat::NO_NODE;
+        }
+        expr = binary(expr, oper, right);
+    }
+
+    return expr;
+}
+
+auto FlatParser::unary() -> Flat::NodeIndex {
+    if (match({TokenType::_minus, TokenType::_bang})) {
+        Flat::TokenIndex oper{previousIndex()};
+        auto right = unary();
+        if (right == Flat::NO_NODE) {
+            return Flat::NO_NODE;
+        }
+        return m_ast.add({Flat::NodeKind::_unary, m_tokens.type(oper), right, 0, oper});
+    }
+
+    return primary();
+}
+
+auto FlatParser::primary() -> Flat::NodeIndex {
+    if (match({TokenType::_true, TokenType::_false, TokenType::_nil, TokenType::_number,
+               TokenType::_string})) {
+        Flat::TokenIndex literal{previousIndex()};
+        return m_ast.add(
+            {Flat::NodeKind::_literal, m_tokens.type(literal), 0, 0, literal});
+    }
+    if (match({TokenType::_left_paren})) {
+        auto expr = expression();
+        if (expr == Flat::NO_NODE ||
+            !consume(TokenType::_right_paren, "Expect ')' after expression.")) {
+            return Flat::NO_NODE;
+        }
+        return m_ast.add({Flat::NodeKind::_grouping, TokenType::_left_paren, expr, 0, 0});
+    }
+    if (match({TokenType::_identifier})) {
+        Flat::TokenIndex name{previousIndex()};
+        return m_ast.add({Flat::NodeKind::_variable, TokenType::_identifier, 0, 0, name});
+    }
+
+    error(peek(), "Expected expression.");
+    return Flat::NO_NODE;
+}
+
+auto FlatParser::binary(Flat::NodeIndex left, Flat::TokenIndex oper, Flat::NodeIndex right)
+    -> Flat::NodeIndex {
+    return m_ast.add({Flat::NodeKind::_binary, m_tokens.type(oper), left, right, oper});
+}
+
+auto FlatParser::previousIndex() const -> Flat::TokenIndex {
+    return static_cast<Flat::TokenIndex>(m_stream.position() - 1);
+}
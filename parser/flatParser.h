@@ -0,0 +1,51 @@
+#ifndef FLAT_PARSER_H
+#define FLAT_PARSER_H
+
+#include "ast/flatAst.h"
+#include "lexer/tokenList.h"
+#include "parserBase.h"
+#include <iostream>
+#include <optional>
+#include <ostream>
+
+/*
+ * Recursive descent parser building a Flat::Ast. Same grammar as Parser, but nodes are appended
+ * into one arena instead of being allocated one by one.
+ */
+class FlatParser : public ParserBase {
+  public:
+    // Nodes refer to tokens by index, so this parser always needs the fully lexed list.
+    FlatParser(const TokenList& tokens, std::ostream& out = std::cout,
+               std::ostream& err = std::cerr)
+        : ParserBase{tokens, out, err}, m_tokens{tokens} {
+        // A tree never has more nodes than there are tokens.
+        m_ast.reserve(tokens.size());
+    }
+    FlatParser(TokenList&&, std::ostream& out = std::cout, std::ostream& err = std::cerr) = delete;
+
+    /*
+     * Kicks off the parsing of an AST. Token indices in the returned tree refer to the list
+     * this parser was constructed with.
+     */
+    std::optional<Flat::Ast> parse();
+
+  private:
+    /*
+     * Recursive functions to consume.
+     */
+    Flat::NodeIndex expression();
+    Flat::NodeIndex equality();
+    Flat::NodeIndex comparison();
+    Flat::NodeIndex term();
+    Flat::NodeIndex factor();
+    Flat::NodeIndex unary();
+    Flat::NodeIndex primary();
+
+    Flat::NodeIndex binary(Flat::NodeIndex left, Flat::TokenIndex oper, Flat::NodeIndex right);
+    Flat::TokenIndex previousIndex() const;
+
+    const TokenList& m_tokens;
+    Flat::Ast m_ast;
+};
+
+#endif // FLAT_PARSER_H
@@ -0,0 +1,191 @@
+#ifndef PARALLEL_PARSER_H
+#define PARALLEL_PARSER_H
+
+#include "ast/statementTrees.h"
+#include "lexer/tokenList.h"
+#include "memory/allocationStats.h"
+#include "parser.h"
+#include "typing/tokentypes.h"
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <print>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/*
+ * Parses a program on several threads, with the same statements and the same errors, in the same
+ * order, as Parser::parseProgram().
+ *
+ * Whatever happened before it, the parser always starts a statement right after a ';' (see
+ * Parser::statements()), so the token list can be cut there and each slice parsed by a Parser of
+ * its own. Cuts are made at ';'s outside of any parentheses, one slice per thread. Errors are
+ * buffered per slice; statements and errors are concatenated in slice order.
+ *
+ * Programs under two slices, or a single thread, go to Parser directly.
+ */
+template <typename R>
+class ParallelParser {
+  public:
+    // Smaller slices would not pay for the threads.
+    static constexpr std::size_t MIN_SLICE_TOKENS{64 * 1024};
+
+    // Borrows the tokens, like Parser. Benchmarks and tests lower `minSliceTokens` to split
+    // programs that would otherwise be parsed in one piece.
+    ParallelParser(const TokenList& tokens, std::size_t threads, std::ostream& out = std::cout,
+                   std::ostream& err = std::cerr, std::size_t minSliceTokens = MIN_SLICE_TOKENS)
+        : m_tokens{tokens}, m_threads{threads}, m_minSliceTokens{minSliceTokens}, m_out{out},
+          m_err{err} {}
+    ParallelParser(TokenList&&, std::size_t threads, std::ostream& out = std::cout,
+                   std::ostream& err = std::cerr,
+                   std::size_t minSliceTokens = MIN_SLICE_TOKENS) = delete;
+
+    ParallelParser(const ParallelParser&) = delete;
+    ParallelParser& operator=(const ParallelParser&) = delete;
+
+    ParallelParser(ParallelParser&&) noexcept = delete;
+    ParallelParser& operator=(ParallelParser&&) = delete;
+
+    ~ParallelParser() = default;
+
+    std::optional<Statement::Program<R>> parseProgram();
+
+    bool hadError() const {
+        return m_hadError;
+    }
+
+  private:
+    struct Slice {
+        std::size_t begin{0};
+        std::size_t end{0};
+
+        Statement::Program<R> program;
+        std::ostringstream out;
+        std::ostringstream err;
+        std::optional<std::string_view> parseError;
+        bool hadError{false};
+        // What an exception thrown while parsing said.
+        std::optional<std::string> failure;
+    };
+
+    std::vector<Slice> split() const;
+    void parse(Slice& slice) const;
+
+    const TokenList& m_tokens;
+    std::size_t m_threads;
+    std::size_t m_minSliceTokens;
+    std::ostream& m_out;
+    std::ostream& m_err;
+    bool m_hadError{false};
+};
+
+template <typename R>
+auto ParallelParser<R>::parseProgram() -> std::optional<Statement::Program<R>> {
+    std::vector<Slice> slices{split()};
+    if (slices.size() < 2) {
+        Parser<R> parser{m_tokens, m_out, m_err};
+        auto program = parser.parseProgram();
+        m_hadError = parser.hadError();
+        return program;
+    }
+
+    // Nodes get their lines from the list, which must not build its line index on every thread.
+    m_tokens.indexLines();
+    {
+        std::vector<std::jthread> threads{};
+        threads.reserve(slices.size() - 1);
+        for (std::size_t i{1}; i < slices.size(); ++i) {
+            threads.emplace_back([this, &slice = slices[i]] { parse(slice); });
+        }
+        parse(slices.front());
+    } // jthreads join here.
+
+    Statement::Program<R> program{};
+    std::optional<std::string_view> parseError{};
+    for (Slice& slice : slices) {
+        m_out << slice.out.view();
+        m_err << slice.err.view();
+        m_hadError = m_hadError || slice.hadError;
+
+        if (slice.failure.has_value()) {
+            // The parser would have stopped right there.
+            std::println(m_err, "Unknown error caught at top level parseProgram(): {}",
+                         slice.failure.value());
+            return std::nullopt;
+        }
+        if (!parseError.has_value()) {
+            parseError = slice.parseError;
+        }
+        std::move(slice.program.begin(), slice.program.end(), std::back_inserter(program));
+    }
+
+    if (parseError.has_value()) {
+        std::println(m_err, "Parse error caught at top level parseProgram(): {}",
+                     parseError.value());
+        return std::nullopt;
+    }
+    return program;
+}
+
+// About equal slices, all but the last ending with a ';' at depth 0.
+template <typename R>
+auto ParallelParser<R>::split() const -> std::vector<Slice> {
+    std::size_t size{m_tokens.size()};
+    std::size_t fits{size / std::max<std::size_t>(m_minSliceTokens, 1)};
+    std::size_t count{std::clamp<std::size_t>(fits, 1, std::max<std::size_t>(m_threads, 1))};
+
+    std::vector<Slice> slices{};
+    slices.reserve(count);
+    std::size_t begin{0};
+    int depth{0};
+    for (std::size_t i{0}; i < size && slices.size() + 1 < count; ++i) {
+        switch (m_tokens.type(static_cast<TokenList::Index>(i))) {
+        case TokenType::_left_paren:
+        case TokenType::_left_brace:
+            ++depth;
+            break;
+        case TokenType::_right_paren:
+        case TokenType::_right_brace:
+            // Stray closers are syntax errors, they do not open anything back up.
+            depth = std::max(depth - 1, 0);
+            break;
+        case TokenType::_semicolon:
+            if (depth == 0 && i + 1 >= size * (slices.size() + 1) / count) {
+                Slice& slice{slices.emplace_back()};
+                slice.begin = begin;
+                slice.end = i + 1;
+                begin = i + 1;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    Slice& last{slices.emplace_back()};
+    last.begin = begin;
+    last.end = size;
+    return slices;
+}
+
+template <typename R>
+void ParallelParser<R>::parse(Slice& slice) const {
+    AllocationStats::Scope phase{Phase::_parse};
+    try {
+        Parser<R> parser{m_tokens, slice.out, slice.err};
+        slice.program = parser.parseStatements(slice.begin, slice.end);
+        slice.parseError = parser.parseError();
+        slice.hadError = parser.hadError();
+    } catch (const std::exception& e) {
+        slice.failure = e.what();
+    }
+}
+
+#endif // PARALLEL_PARSER_H
@@ -2,42 +2,59 @@
 #define PARSER_H
 
 #include "ast/expressionTrees.h"
-#include "error/error.h"
+#include "ast/statementTrees.h"
+#include "parserBase.h"
 #include "typing/token.h"
-#include <cassert>
-#include <initializer_list>
-#include <iterator>
+#include <cstddef>
+#include <iostream>
+#include <limits>
 #include <memory>
-#include <stdexcept>
-#include <vector>
+#include <optional>
+#include <ostream>
+#include <print>
 
 /*
  * Recursive descent parser.
  * Concrete implementation are at the bottom of the file. This is required due to templating.
  */
 template <typename R>
-class Parser {
+class Parser : public ParserBase {
   public:
-    Parser(const std::vector<Token>& tokens) : m_tokens{tokens} {}
-    // or: Parser(std::vector<Token> tokens) : m_tokens{std::move(tokens)} {}
+    // Borrows the tokens, they must outlive the parser.
+    Parser(const TokenList& tokens, std::ostream& out = std::cout, std::ostream& err = std::cerr)
+        : ParserBase{tokens, out, err} {}
+    Parser(TokenList&&, std::ostream& out = std::cout, std::ostream& err = std::cerr) = delete;
+
+    // Streaming mode, see TokenStream.
+    Parser(Lexer& lexer, std::ostream& out = std::cout, std::ostream& err = std::cerr)
+        : ParserBase{lexer, out, err} {}
 
     /*
      * Kicks off the parsing of an AST.
      */
     std::unique_ptr<Expression::Expression<R>> parse();
-    bool hadError() {
-        return m_errorReporter.hadError();
-    }
-    bool hadRuntimeError() {
-        return m_errorReporter.hadRuntimeError();
-    }
 
-  private:
-    struct ParseError;
+    /*
+     * Parses a whole program, statement* EOF. After an error it skips to the start of the next
+     * statement and carries on, so every statement gets its first error reported. Empty if there
+     * was any.
+     */
+    std::optional<Statement::Program<R>> parseProgram();
 
+    /*
+     * The statements starting from token `begin` up to token `end`. Both must be where a statement
+     * starts: the first token, or right after a ';'. Errors are reported like parseProgram() does,
+     * only the summary is left to the caller. Token lists only, ParallelParser parses its slices
+     * with it.
+     */
+    Statement::Program<R> parseStatements(std::size_t begin, std::size_t end);
+
+  private:
     /*
      * Recursive functions to consume.
      */
+    Statement::Program<R> statements(std::size_t end);
+    std::unique_ptr<Statement::Statement<R>> statement();
     std::unique_ptr<Expression::Expression<R>> expression();
     std::unique_ptr<Expression::Expression<R>> equality();
     std::unique_ptr<Expression::Expression<R>> comparison();
@@ -45,43 +62,87 @@ class Parser {
     std::unique_ptr<Expression::Expression<R>> factor();
     std::unique_ptr<Expression::Expression<R>> unary();
     std::unique_ptr<Expression::Expression<R>> primary();
-
-    /*
-     * Helper functions to perform parsing.
-     */
-    bool match(std::initializer_list<TokenType> types);
-    bool check(TokenType type);
-    bool isAtEnd();
-    Token advance();
-    Token previous();
-    Token peek();
-    Token consume(TokenType type, std::string_view message);
-    ParseError error(Token token, std::string_view message);
-    void synchronize();
-
-  private:
-    struct ParseError : public std::runtime_error {
-        explicit ParseError(std::string msg) : std::runtime_error(std::move(msg)) {}
-    };
-
-    std::vector<Token> m_tokens;
-    int m_current{0};
-    ErrorReporter m_errorReporter{"Parser"};
 };
 
 template <typename R>
 auto Parser<R>::parse() -> std::unique_ptr<Expression::Expression<R>> {
     try {
-        return expression();
-    } catch (const ParseError& e) {
-        std::println(std::cerr, "Parse error caught at top level parse(): {}", e.what());
+        auto expr = expression();
+        if (m_parseError.has_value()) {
+            std::println(m_errorReporter.err(), "Parse error caught at top level parse(): {}",
+                         m_parseError.value());
+            return nullptr;
+        }
+        return expr;
+    } catch (const std::exception& e) {
+        std::println(m_errorReporter.err(), "Unknown error caught at top level parse(): {}",
+                     e.what());
         return nullptr;
+    }
+}
+
+template <typename R>
+auto Parser<R>::parseProgram() -> std::optional<Statement::Program<R>> {
+    try {
+        auto program = statements(std::numeric_limits<std::size_t>::max());
+        if (m_parseError.has_value()) {
+            std::println(m_errorReporter.err(),
+                         "Parse error caught at top level parseProgram(): {}",
+                         m_parseError.value());
+            return std::nullopt;
+        }
+        return program;
     } catch (const std::exception& e) {
-        std::println(std::cerr, "Unknown error caught at top level parse(): {}", e.what());
+        std::println(m_errorReporter.err(), "Unknown error caught at top level parseProgram(): {}",
+                     e.what());
+        return std::nullopt;
+    }
+}
+
+template <typename R>
+auto Parser<R>::parseStatements(std::size_t begin, std::size_t end) -> Statement::Program<R> {
+    this->m_stream.seek(begin);
+    return statements(end);
+}
+
+/*
+ * A statement only ever ends right after a ';': the one it consumes last, or the first one
+ * synchronize() skips past after an error. Expressions never contain one.
+ */
+template <typename R>
+auto Parser<R>::statements(std::size_t end) -> Statement::Program<R> {
+    Statement::Program<R> program{};
+    while (!this->isAtEnd() && this->m_stream.position() < end) {
+        if (auto statement = this->statement()) {
+            program.push_back(std::move(statement));
+        } else {
+            this->synchronize();
+        }
+    }
+    return program;
+}
+
+template <typename R>
+auto Parser<R>::statement() -> std::unique_ptr<Statement::Statement<R>> {
+    if (this->match({TokenType::_print})) {
+        auto expr = this->expression();
+        if (!expr || !this->consume(TokenType::_semicolon, "Expect ';' after value.")) {
+            return nullptr;
+        }
+        return std::make_unique<Statement::PrintStatement<R>>(std::move(expr));
+    }
+
+    auto expr = this->expression();
+    if (!expr || !this->consume(TokenType::_semicolon, "Expect ';' after expression.")) {
         return nullptr;
     }
+    return std::make_unique<Statement::ExpressionStatement<R>>(std::move(expr));
 }
 
+/*
+ * Every rule returns nullptr once an error has been reported, and passes a nullptr from the rules
+ * it calls straight up.
+ */
 template <typename R>
 auto Parser<R>::expression() -> std::unique_ptr<Expression::Expression<R>> {
     return this->equality();
@@ -90,9 +151,12 @@ template <typename R>
 auto Parser<R>::equality() -> std::unique_ptr<Expression::Expression<R>> {
     auto expr = this->comparison();
 
-    while (this->match({TokenType::_bang_equal, TokenType::_equal_equal})) {
+    while (expr && this->match({TokenType::_bang_equal, TokenType::_equal_equal})) {
         Token oper = this->previous();
         auto right = this->comparison();
+        if (!right) {
+            return nullptr;
+        }
         expr = std::make_unique<Expression::Binary<R>>(std::move(expr), oper, std::move(right));
     }
 
@@ -103,10 +167,13 @@ template <typename R>
 auto Parser<R>::comparison() -> std::unique_ptr<Expression::Expression<R>> {
     auto expr = this->term();
 
-    while (this->match({TokenType::_greater, TokenType::_greater_equal, TokenType::_less,
-                        TokenType::_less_equal})) {
+    while (expr && this->match({TokenType::_greater, TokenType::_greater_equal, TokenType::_less,
+                                TokenType::_less_equal})) {
         Token oper = this->previous();
         auto right = this->term();
+        if (!right) {
+            return nullptr;
+        }
         expr = std::make_unique<Expression::Binary<R>>(std::move(expr), oper, std::move(right));
     }
 
@@ -117,9 +184,12 @@ template <typename R>
 auto Parser<R>::term() -> std::unique_ptr<Expression::Expression<R>> {
     auto expr = this->factor();
 
-    while (this->match({TokenType::_minus, TokenType::_plus})) {
+    while (expr && this->match({TokenType::_minus, TokenType::_plus})) {
         Token oper = this->previous();
         auto right = this->factor();
+        if (!right) {
+            return nullptr;
+        }
         expr = std::make_unique<Expression::Binary<R>>(std::move(expr), oper, std::move(right));
     }
 
@@ -130,9 +200,12 @@ template <typename R>
 auto Parser<R>::factor() -> std::unique_ptr<Expression::Expression<R>> {
     auto expr = this->unary();
 
-    while (this->match({TokenType::_slash, TokenType::_star})) {
+    while (expr && this->match({TokenType::_slash, TokenType::_star})) {
         Token oper = this->previous();
         auto right = this->unary();
+        if (!right) {
+            return nullptr;
+        }
         expr = std::make_unique<Expression::Binary<R>>(std::move(expr), oper, std::move(right));
     }
 
@@ -144,6 +217,9 @@ auto Parser<R>::unary() -> std::unique_ptr<Expression::Expression<R>> {
     if (this->match({TokenType::_minus, TokenType::_bang})) {
         Token oper = this->previous();
         auto right = this->unary();
+        if (!right) {
+            return nullptr;
+        }
         return std::make_unique<Expression::Unary<R>>(oper, std::move(right));
     }
 
@@ -159,104 +235,24 @@ auto Parser<R>::primary() -> std::unique_ptr<Expression::Expression<R>> {
         return std::make_unique<Expression::Literal<R>>(false);
     }
     if (this->match({TokenType::_nil})) {
-        return std::make_unique<Expression::Literal<R>>(std::nullopt);
+        return std::make_unique<Expression::Literal<R>>(Value{});
     }
     if (this->match({TokenType::_number, TokenType::_string})) {
-        return std::make_unique<Expression::Literal<R>>(this->previous().getLiteral());
+        return std::make_unique<Expression::Literal<R>>(this->previousLiteral());
     }
     if (this->match({TokenType::_left_paren})) {
         auto expr = this->expression();
-        this->consume(TokenType::_right_paren, "Expect ')' after expression.");
-        return std::make_unique<Expression::Grouping<R>>(std::move(expr));
-    }
-
-    throw this->error(this->peek(), "Expected expression.");
-}
-
-// Helper functions
-template <typename R>
-auto Parser<R>::match(std::initializer_list<TokenType> types) -> bool {
-    for (auto type : types) {
-        if (check(type)) {
-            advance();
-            return true;
+        if (!expr || !this->consume(TokenType::_right_paren, "Expect ')' after expression.")) {
+            return nullptr;
         }
+        return std::make_unique<Expression::Grouping<R>>(std::move(expr));
     }
-    return false;
-}
-
-template <typename R>
-auto Parser<R>::check(TokenType type) -> bool {
-    if (isAtEnd()) {
-        return false;
+    if (this->match({TokenType::_identifier})) {
+        return std::make_unique<Expression::Variable<R>>(this->previous());
     }
-    return peek().getType() == type;
-}
 
-template <typename R>
-auto Parser<R>::advance() -> Token {
-    if (!isAtEnd()) {
-        ++m_current;
-    }
-    return previous();
-}
-
-template <typename R>
-auto Parser<R>::isAtEnd() -> bool {
-    return peek().getType() == TokenType::_eof;
-}
-
-template <typename R>
-auto Parser<R>::peek() -> Token {
-    assert(m_current < std::ssize(m_tokens) && "Out of bounds access.");
-    return m_tokens[m_current];
-}
-
-template <typename R>
-auto Parser<R>::previous() -> Token {
-    assert(m_current - 1 < std::ssize(m_tokens) && "Out of bounds access.");
-    return m_tokens[m_current - 1];
-}
-
-template <typename R>
-auto Parser<R>::consume(TokenType type, std::string_view message) -> Token {
-    if (check(type)) {
-        return advance();
-    }
-    throw error(peek(), message);
-}
-
-template <typename R>
-auto Parser<R>::error(Token token, std::string_view message) -> ParseError {
-    m_errorReporter.error(token, message);
-    return ParseError{std::string{message}};
-}
-
-template <typename R>
-auto Parser<R>::synchronize() -> void {
-    advance();
-
-    while (!isAtEnd()) {
-        if (previous().getType() == TokenType::_semicolon) {
-            return;
-        }
-
-        switch (peek().getType()) {
-        case TokenType::_class:
-        case TokenType::_fun:
-        case TokenType::_var:
-        case TokenType::_for:
-        case TokenType::_if:
-        case TokenType::_while:
-        case TokenType::_print:
-        case TokenType::_return:
-            return;
-        default:
-            break;
-        }
-
-        advance();
-    }
+    this->error(this->peek(), "Expected expression.");
+    return nullptr;
 }
 
 #endif // PARSER_H
@@ -0,0 +1,162 @@
+#ifndef PARSER_BASE_H
+#define PARSER_BASE_H
+
+#include "error/error.h"
+#include "lexer/lexer.h"
+#include "lexer/tokenList.h"
+#include "tokenStream.h"
+#include "typing/token.h"
+#include <initializer_list>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/*
+ * Token cursor and error handling shared by the recursive descent parsers. Derived parsers only
+ * implement the grammar rules and decide what kind of tree to build.
+ *
+ * Errors do not throw. error() reports and records the first one, and grammar rules return an
+ * empty result that every rule above them passes straight up.
+ */
+class ParserBase {
+  public:
+    // Borrows the tokens, they must outlive the parser.
+    ParserBase(const TokenList& tokens, std::ostream& out = std::cout,
+               std::ostream& err = std::cerr)
+        : m_stream{tokens}, m_errorReporter{"Parser", out, err} {}
+    ParserBase(TokenList&&, std::ostream& out = std::cout, std::ostream& err = std::cerr) = delete;
+
+    // Streaming mode, tokens are lexed only as the parser reaches them.
+    ParserBase(Lexer& lexer, std::ostream& out = std::cout, std::ostream& err = std::cerr)
+        : m_stream{lexer}, m_errorReporter{"Parser", out, err} {}
+
+    bool hadError() {
+        return m_errorReporter.hadError();
+    }
+    bool hadRuntimeError() {
+        return m_errorReporter.hadRuntimeError();
+    }
+    // Message of the first error reported, if any.
+    std::optional<std::string_view> parseError() const {
+        return m_parseError;
+    }
+    /*
+     * For callers that parse a lone expression, which stops wherever the expression ends: reports
+     * `message` at the first token left over, if there is one.
+     */
+    bool expectEnd(std::string_view message);
+
+  protected:
+    /*
+     * Helper functions to perform parsing. Moving through the tokens only looks at their types,
+     * previous() and peek() build a full Token and are meant for AST nodes and diagnostics.
+     */
+    bool match(std::initializer_list<TokenType> types);
+    bool check(TokenType type);
+    bool isAtEnd();
+    void advance();
+    Token previous();
+    const Value& previousLiteral();
+    Token peek();
+    bool consume(TokenType type, std::string_view message);
+    void error(const Token& token, std::string_view message);
+    void synchronize();
+
+    TokenStream m_stream;
+    ErrorReporter m_errorReporter{"Parser"};
+    // Message of the error that stopped the parse, always a string literal.
+    std::optional<std::string_view> m_parseError;
+};
+
+inline auto ParserBase::match(std::initializer_list<TokenType> types) -> bool {
+    for (auto type : types) {
+        if (check(type)) {
+            advance();
+            return true;
+        }
+    }
+    return false;
+}
+
+inline auto ParserBase::check(TokenType type) -> bool {
+    if (isAtEnd()) {
+        return false;
+    }
+    return m_stream.peekType() == type;
+}
+
+inline auto ParserBase::advance() -> void {
+    if (!isAtEnd()) {
+        m_stream.advance();
+    }
+}
+
+inline auto ParserBase::isAtEnd() -> bool {
+    return m_stream.peekType() == TokenType::_eof;
+}
+
+inline auto ParserBase::peek() -> Token {
+    return m_stream.peekToken();
+}
+
+inline auto ParserBase::previous() -> Token {
+    return m_stream.previousToken();
+}
+
+inline auto ParserBase::previousLiteral() -> const Value& {
+    return m_stream.previousLiteral();
+}
+
+inline auto ParserBase::consume(TokenType type, std::string_view message) -> bool {
+    if (check(type)) {
+        advance();
+        return true;
+    }
+    error(peek(), message);
+    return false;
+}
+
+inline auto ParserBase::expectEnd(std::string_view message) -> bool {
+    if (isAtEnd()) {
+        return true;
+    }
+    error(peek(), message);
+    return false;
+}
+
+inline auto ParserBase::error(const Token& token, std::string_view message) -> void {
+    m_errorReporter.error(token, message);
+    if (!m_parseError.has_value()) {
+        m_parseError = message;
+    }
+}
+
+inline auto ParserBase::synchronize() -> void {
+    advance();
+
+    while (!isAtEnd()) {
+        if (m_stream.previousType() == TokenType::_semicolon) {
+            return;
+        }
+
+        switch (m_stream.peekType()) {
+        case TokenType::_class:
+        case TokenType::_fun:
+        case TokenType::_var:
+        case TokenType::_for:
+        case TokenType::_if:
+        case TokenType::_while:
+        case TokenType::_print:
+        case TokenType::_return:
+            return;
+        default:
+            break;
+        }
+
+        advance();
+    }
+}
+
+#endif // PARSER_BASE_H
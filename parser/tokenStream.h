@@ -0,0 +1,108 @@
+#ifndef TOKEN_STREAM_H
+#define TOKEN_STREAM_H
+
+#include "lexer/lexer.h"
+#include "lexer/tokenList.h"
+#include "typing/token.h"
+#include "typing/tokentypes.h"
+#include "typing/value.h"
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+/*
+ * The parser's view of the tokens. Either borrows a fully lexed TokenList, or pulls tokens from a
+ * Lexer on demand into a small ring buffer. The grammar only ever looks at the current and the
+ * previous token, so in streaming mode memory stays constant no matter how long the script is.
+ *
+ * Navigating only touches token types; full Tokens are built by peekToken()/previousToken() when
+ * the parser actually needs one for a node or a diagnostic.
+ */
+class TokenStream {
+  public:
+    // The list is borrowed and must outlive the stream.
+    explicit TokenStream(const TokenList& tokens) : m_tokens{&tokens} {}
+    explicit TokenStream(TokenList&&) = delete;
+
+    explicit TokenStream(Lexer& lexer) : m_lexer{&lexer} {}
+
+    TokenType peekType() {
+        if (m_tokens != nullptr) {
+            return m_tokens->type(current());
+        }
+        return pull().getType();
+    }
+
+    TokenType previousType() {
+        if (m_tokens != nullptr) {
+            return m_tokens->type(previous());
+        }
+        return m_ring[previous() % RING_SIZE].getType();
+    }
+
+    const Value& previousLiteral() {
+        if (m_tokens != nullptr) {
+            return m_tokens->literal(previous());
+        }
+        return m_ring[previous() % RING_SIZE].getLiteral();
+    }
+
+    Token peekToken() {
+        if (m_tokens != nullptr) {
+            return m_tokens->token(current());
+        }
+        return pull();
+    }
+
+    Token previousToken() {
+        if (m_tokens != nullptr) {
+            return m_tokens->token(previous());
+        }
+        return m_ring[previous() % RING_SIZE];
+    }
+
+    void advance() {
+        ++m_current;
+    }
+
+    // Moves to token `position` of the list. A lexer cannot be rewound.
+    void seek(std::size_t position) {
+        assert(m_tokens != nullptr && "Only a token list can seek.");
+        m_current = position;
+    }
+
+    // Index of the current token in the whole stream.
+    std::size_t position() const {
+        return m_current;
+    }
+
+  private:
+    static constexpr std::size_t RING_SIZE{4};
+
+    TokenList::Index current() const {
+        assert(m_current < m_tokens->size() && "Out of bounds access.");
+        return static_cast<TokenList::Index>(m_current);
+    }
+
+    TokenList::Index previous() const {
+        assert(m_current > 0 && "No previous token.");
+        return static_cast<TokenList::Index>(m_current - 1);
+    }
+
+    // Pull until the current token is in the ring.
+    const Token& pull() {
+        while (m_pulled <= m_current) {
+            m_ring[m_pulled % RING_SIZE] = m_lexer->nextToken();
+            ++m_pulled;
+        }
+        return m_ring[m_current % RING_SIZE];
+    }
+
+    const TokenList* m_tokens{nullptr};
+    Lexer* m_lexer{nullptr};
+    std::array<Token, RING_SIZE> m_ring{};
+    std::size_t m_current{0};
+    std::size_t m_pulled{0};
+};
+
+#endif // TOKEN_STREAM_H
@@ -0,0 +1,85 @@
+#include "sourceBuffer.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+auto SourceBuffer::fromFile(const std::string& path) -> SourceBuffer {
+    bool isStdin{path == "-"};
+    int fd{isStdin ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd < 0) {
+        throw std::system_error{errno, std::generic_category(), path};
+    }
+
+    SourceBuffer buffer{};
+
+    struct stat info{};
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* mapped{::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE,
+                            fd, 0)};
+        if (mapped != MAP_FAILED) {
+            buffer.m_mapped = static_cast<const char*>(mapped);
+            buffer.m_size = static_cast<std::size_t>(info.st_size);
+        }
+    }
+
+    // Not a regular file, empty, or the mapping failed: fall back to reading it once.
+    if (buffer.m_mapped == nullptr) {
+        try {
+            buffer = readAll(fd, path);
+        } catch (...) {
+            if (!isStdin) {
+                ::close(fd);
+            }
+            throw;
+        }
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    if (!isStdin) {
+        ::close(fd);
+    }
+
+    return buffer;
+}
+
+auto SourceBuffer::readAll(int fd, const std::string& path) -> SourceBuffer {
+    SourceBuffer buffer{};
+
+    char chunk[64 * 1024];
+    while (true) {
+        ssize_t count{::read(fd, chunk, sizeof(chunk))};
+        if (count == 0) {
+            break;
+        }
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error{errno, std::generic_category(), path};
+        }
+        buffer.m_owned.append(chunk, static_cast<std::size_t>(count));
+    }
+
+    return buffer;
+}
+
+SourceBuffer::SourceBuffer(SourceBuffer&& other) noexcept
+    : m_mapped{std::exchange(other.m_mapped, nullptr)}, m_size{std::exchange(other.m_size, 0)},
+      m_owned{std::move(other.m_owned)} {}
+
+SourceBuffer& SourceBuffer::operator=(SourceBuffer&& other) noexcept {
+    std::swap(m_mapped, other.m_mapped);
+    std::swap(m_size, other.m_size);
+    std::swap(m_owned, other.m_owned);
+    return *this;
+}
+
+SourceBuffer::~SourceBuffer() {
+    if (m_mapped != nullptr) {
+        ::munmap(const_cast<char*>(m_mapped), m_size);
+    }
+}
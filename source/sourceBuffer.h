@@ -0,0 +1,43 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/*
+ * Owns the text of a script for the whole run. Regular files are memory-mapped, anything that
+ * cannot be mapped (pipes, terminals) is read once into memory. The lexer, the tokens and the
+ * error reporter only ever borrow views into this buffer, so it must outlive them.
+ */
+class SourceBuffer {
+  public:
+    /*
+     * Loads a script, "-" reads standard input. Throws std::system_error if the file cannot be
+     * opened or read.
+     */
+    static SourceBuffer fromFile(const std::string& path);
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    SourceBuffer(SourceBuffer&& other) noexcept;
+    SourceBuffer& operator=(SourceBuffer&& other) noexcept;
+
+    ~SourceBuffer();
+
+    std::string_view view() const {
+        return m_mapped != nullptr ? std::string_view{m_mapped, m_size} : std::string_view{m_owned};
+    }
+
+  private:
+    SourceBuffer() = default;
+
+    static SourceBuffer readAll(int fd, const std::string& path);
+
+    const char* m_mapped{nullptr};
+    std::size_t m_size{0};
+    std::string m_owned;
+};
+
+#endif // SOURCE_BUFFER_H
@@ -0,0 +1,141 @@
+#include "check.h"
+#include "driver/session.h"
+#include "vm/bytecodeCache.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+/*
+ * The vm engine with the bytecode cache in a directory of its own: whatever is in the cache, a
+ * run has to print what a run without it prints. Entries that cannot be used count as misses,
+ * the script is lexed, parsed and compiled again and the entry rewritten.
+ */
+namespace {
+
+constexpr std::string_view SCRIPT{"(1 + 2) * 3 - \"a\" + \"b\" == nil"};
+// As long as SCRIPT, so only the stored source bytes tell their entries apart.
+constexpr std::string_view OTHER_SCRIPT{"(1 + 2) * 3 - \"a\" + \"c\" == nil"};
+
+// Where Header keeps the hash of the source, after magic, version, layout and foldedNodes.
+constexpr std::size_t HASH_OFFSET{16};
+
+std::string run(const Options& options, std::string_view script) {
+    std::ostringstream out{};
+    std::ostringstream err{};
+    Session session{options, out, err};
+    session.run(script);
+    return out.str() + err.str() + "[" + std::to_string(session.exitStatus()) + "]";
+}
+
+std::string runVm(std::string_view script, bool cache = true, bool optimize = false) {
+    return run({.engine = Engine::_vm, .optimize = optimize, .cache = cache}, script);
+}
+
+// The file BytecodeCache::store() writes the entry for this script to.
+std::filesystem::path entryFor(const std::filesystem::path& directory, std::string_view script) {
+    char name[17]{};
+    std::snprintf(name, sizeof(name), "%016llx",
+                  static_cast<unsigned long long>(BytecodeCache::hash(script)));
+    return directory / (std::string{name} + ".loxc");
+}
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream in{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+void writeFile(const std::filesystem::path& path, std::string_view bytes) {
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+struct Counters {
+    std::uint64_t hits;
+    std::uint64_t misses;
+
+    bool operator==(const Counters&) const = default;
+};
+
+Counters counters() {
+    return {BytecodeCache::global().hits(), BytecodeCache::global().misses()};
+}
+
+/*
+ * Replaces the entry for SCRIPT with the given bytes, then checks that the next run misses, still
+ * prints the right thing, and leaves a good entry behind for the run after it.
+ */
+void checkFallback(const std::filesystem::path& directory, std::string_view what,
+                   std::string_view bytes, const std::string& expected) {
+    writeFile(entryFor(directory, SCRIPT), bytes);
+
+    Counters before{counters()};
+    Check::check(runVm(SCRIPT) == expected, what);
+    Check::check(counters() == Counters{before.hits, before.misses + 1}, what);
+
+    Check::check(runVm(SCRIPT) == expected, what);
+    Check::check(counters() == Counters{before.hits + 1, before.misses + 1}, what);
+}
+
+} // namespace
+
+int main() {
+    std::filesystem::path directory{std::filesystem::temp_directory_path() /
+                                    ("lox-cache-test-" + std::to_string(::getpid()))};
+    std::filesystem::remove_all(directory);
+    // Read once, by the first BytecodeCache::global().
+    ::setenv("LOX_CACHE_DIR", directory.c_str(), 1);
+
+    std::string expected{run({.engine = Engine::_tree}, SCRIPT)};
+
+    // Miss, then hit.
+    Check::check(runVm(SCRIPT) == expected, "miss");
+    Check::check(counters() == Counters{0, 1}, "miss counted");
+    Check::check(std::filesystem::exists(entryFor(directory, SCRIPT)), "entry written");
+    Check::check(runVm(SCRIPT) == expected, "hit");
+    Check::check(counters() == Counters{1, 1}, "hit counted");
+
+    // --no-cache neither reads nor writes.
+    Check::check(runVm(OTHER_SCRIPT, false) == run({.engine = Engine::_tree}, OTHER_SCRIPT),
+                 "no cache");
+    Check::check(counters() == Counters{1, 1}, "no cache not counted");
+    Check::check(!std::filesystem::exists(entryFor(directory, OTHER_SCRIPT)), "no cache entry");
+
+    // -O entries are separate, and a hit reports the folding of the run that compiled it.
+    std::string optimized{run({.engine = Engine::_tree, .optimize = true}, SCRIPT)};
+    Check::check(runVm(SCRIPT, true, true) == optimized, "-O miss");
+    Check::check(runVm(SCRIPT, true, true) == optimized, "-O hit");
+    Check::check(counters() == Counters{2, 2}, "-O counted");
+
+    std::string good{readFile(entryFor(directory, SCRIPT))};
+
+    std::string badMagic{good};
+    badMagic[0] = 'X';
+    checkFallback(directory, "bad magic", badMagic, expected);
+
+    checkFallback(directory, "truncated header", std::string_view{good}.substr(0, 10), expected);
+    checkFallback(directory, "truncated chunk", std::string_view{good}.substr(0, good.size() - 3),
+                  expected);
+
+    // A code size far past the end of the file, right after the stored source.
+    std::string badChunk{good};
+    std::memset(badChunk.data() + good.size() - good.size() / 4, 0xff, good.size() / 4);
+    checkFallback(directory, "corrupt chunk", badChunk, expected);
+
+    // Same hash and size in the header, but another script's source and bytecode behind it.
+    Check::check(runVm(OTHER_SCRIPT) == run({.engine = Engine::_tree}, OTHER_SCRIPT), "other");
+    std::string other{readFile(entryFor(directory, OTHER_SCRIPT))};
+    std::uint64_t hash{BytecodeCache::hash(SCRIPT)};
+    std::memcpy(other.data() + HASH_OFFSET, &hash, sizeof(hash));
+    checkFallback(directory, "other source", other, expected);
+
+    std::filesystem::remove_all(directory);
+    return Check::failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
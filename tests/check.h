@@ -0,0 +1,31 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <iostream>
+#include <print>
+#include <source_location>
+#include <string_view>
+
+/*
+ * Bare-bones assertions for the test executables: a failed check is reported and counted, and
+ * main() returns failures() so ctest sees a non-zero exit code.
+ */
+namespace Check {
+
+inline int& failures() {
+    static int count{0};
+    return count;
+}
+
+inline bool check(bool condition, std::string_view what,
+                  std::source_location where = std::source_location::current()) {
+    if (!condition) {
+        std::println(std::cerr, "{}:{}: check failed: {}", where.file_name(), where.line(), what);
+        ++failures();
+    }
+    return condition;
+}
+
+} // namespace Check
+
+#endif // CHECK_H
@@ -0,0 +1,216 @@
+#include "check.h"
+#include "interpreter/columnInterpreter.h"
+#include "interpreter/interpreter.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Every row the column interpreter evaluates has to come out as the tree interpreter evaluating
+ * the same expression with that row's values written in as literals: same kind, same number down
+ * to the sign of a zero, and for error rows the same error.
+ */
+namespace {
+
+using Kind = ColumnInterpreter::Kind;
+
+// Two full blocks and a partial one.
+constexpr std::size_t ROWS{2 * ColumnInterpreter::BLOCK_SIZE + 37};
+
+constexpr std::array<std::string_view, 24> EXPRESSIONS{
+    "a + b",
+    "a - b * c",
+    "a / b",
+    "-a",
+    "-(a / b) + c",
+    "!a",
+    "!!b == !c",
+    "a < b",
+    "a <= b",
+    "a > b",
+    "a >= b",
+    "a == b",
+    "a != b",
+    "a == nil",
+    "nil != b",
+    "(a + b) == c",
+    "a * (b - c) > 1 == !c",
+    "a == b == c",
+    "true == (a > b)",
+    "(a < b) < c",
+    "a + true",
+    "-(a == b)",
+    "a + zz",
+    "c - -a * (b + 1)",
+};
+
+struct Columns {
+    std::vector<double> a, b, c;
+    std::vector<std::uint8_t> aPresent, bPresent;
+};
+
+// Zeros of both signs, infinities, NaN and nil (through the masks of a and b) in every column.
+Columns makeColumns() {
+    constexpr double INF{std::numeric_limits<double>::infinity()};
+    constexpr std::array<double, 11> VALUES{0.0, -0.0, 1.0, -1.0, 2.5, 0.1, 100.0, 3.0,
+                                            INF, -INF, std::numeric_limits<double>::quiet_NaN()};
+    std::mt19937 random{20};
+    Columns columns{};
+    for (std::size_t row{0}; row < ROWS; ++row) {
+        columns.a.push_back(VALUES[random() % VALUES.size()]);
+        columns.b.push_back(VALUES[random() % VALUES.size()]);
+        columns.c.push_back(VALUES[random() % VALUES.size()]);
+        columns.aPresent.push_back(random() % 5 != 0);
+        columns.bPresent.push_back(random() % 5 != 0);
+    }
+    return columns;
+}
+
+// A literal, or an expression folding to the value, that the tree interpreter reads back exactly.
+std::string literal(double value, bool present) {
+    if (!present) {
+        return "nil";
+    }
+    if (std::isnan(value)) {
+        return "(0 / 0)";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "(1 / 0)" : "(-1 / 0)";
+    }
+    std::array<char, 64> digits{};
+    auto end{std::to_chars(digits.data(), digits.data() + digits.size(), std::fabs(value),
+                           std::chars_format::fixed)
+                 .ptr};
+    std::string text{digits.data(), end};
+    return std::signbit(value) ? "(-" + text + ")" : text;
+}
+
+// `expression` with every a, b and c replaced by the literal of its value in `row`.
+std::string substitute(std::string_view expression, const Columns& columns, std::size_t row) {
+    std::string source{};
+    for (std::size_t i{0}; i < expression.size();) {
+        std::size_t end{i};
+        while (end < expression.size() &&
+               std::isalpha(static_cast<unsigned char>(expression[end])) != 0) {
+            ++end;
+        }
+        std::string_view name{expression.substr(i, end - i)};
+        if (name == "a") {
+            source += literal(columns.a[row], columns.aPresent[row] != 0);
+        } else if (name == "b") {
+            source += literal(columns.b[row], columns.bPresent[row] != 0);
+        } else if (name == "c") {
+            source += literal(columns.c[row], true);
+        } else if (!name.empty()) {
+            source += name;
+        } else {
+            source += expression[end++];
+        }
+        i = end;
+    }
+    return source;
+}
+
+std::unique_ptr<Expression::Expression<Value>> parse(std::string_view source) {
+    std::ostringstream discard{};
+    TokenList tokens{Lexer{source, discard, discard}.lexTokens()};
+    return Parser<Value>{tokens, discard, discard}.parse();
+}
+
+bool sameRow(const ColumnInterpreter& columns, Kind kind, double number, const Value& value,
+             const std::optional<LoxRuntimeError>& error) {
+    switch (kind) {
+    case Kind::_nil:
+        return !error.has_value() && value.isNil();
+    case Kind::_boolean:
+        return !error.has_value() && value.isBoolean() && number == (value.asBoolean() ? 1 : 0);
+    case Kind::_number:
+        if (error.has_value() || !value.isNumber()) {
+            return false;
+        }
+        // Value keeps a single NaN, the sign of NaN is not comparable here.
+        if (std::isnan(number) || std::isnan(value.asNumber())) {
+            return std::isnan(number) && std::isnan(value.asNumber());
+        }
+        return number == value.asNumber() &&
+               std::signbit(number) == std::signbit(value.asNumber());
+    case Kind::_error: {
+        if (!error.has_value()) {
+            return false;
+        }
+        const LoxRuntimeError& raised{columns.error(number)};
+        return std::string_view{raised.what()} == error->what() &&
+               raised.m_token.getLexeme() == error->m_token.getLexeme();
+    }
+    }
+    return false;
+}
+
+void rowByRow(const Columns& columns) {
+    std::array<ColumnInterpreter::Column, 3> bound{{
+        {"a", columns.a, columns.aPresent},
+        {"b", columns.b, columns.bPresent},
+        {"c", columns.c, {}},
+    }};
+    ColumnInterpreter interpreter{};
+    std::ostringstream discard{};
+    Interpreter tree{discard, discard};
+
+    for (std::string_view expression : EXPRESSIONS) {
+        std::vector<Kind> kinds(ROWS);
+        std::vector<double> values(ROWS);
+        if (!Check::check(interpreter.evaluate(*parse(expression), bound, kinds, values),
+                          expression)) {
+            continue;
+        }
+
+        for (std::size_t row{0}; row < ROWS; ++row) {
+            std::string source{substitute(expression, columns, row)};
+            Value value{tree.evaluate(*parse(source))};
+            std::optional<LoxRuntimeError> error{tree.takeError()};
+            if (!Check::check(sameRow(interpreter, kinds[row], values[row], value, error),
+                              expression)) {
+                std::println(std::cerr, "  row {}: {}", row, source);
+                break;
+            }
+        }
+    }
+}
+
+// Trees with strings are refused before anything is written.
+void strings(const Columns& columns) {
+    std::array<ColumnInterpreter::Column, 1> bound{{{"a", columns.a, columns.aPresent}}};
+    ColumnInterpreter interpreter{};
+
+    for (std::string_view expression : {"a + \"x\"", "\"x\" == a", "-a < 1 == (\"s\" == nil)"}) {
+        std::vector<Kind> kinds(ROWS, Kind::_error);
+        std::vector<double> values(ROWS, 42.0);
+        Check::check(!interpreter.evaluate(*parse(expression), bound, kinds, values), expression);
+        Check::check(std::ranges::all_of(kinds, [](Kind kind) { return kind == Kind::_error; }) &&
+                         std::ranges::all_of(values, [](double value) { return value == 42.0; }),
+                     "nothing written for a string expression");
+    }
+}
+
+} // namespace
+
+int main() {
+    Columns columns{makeColumns()};
+    rowByRow(columns);
+    strings(columns);
+    return Check::failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
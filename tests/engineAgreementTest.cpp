@@ -0,0 +1,98 @@
+#include "check.h"
+#include "driver/session.h"
+#include <array>
+#include <cstdlib>
+#include <print>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Every engine has to print exactly what the tree interpreter prints for the same script, down to
+ * the sign of a NaN.
+ */
+namespace {
+
+struct Configuration {
+    std::string_view name;
+    Options options;
+};
+
+const std::array<Configuration, 7> CONFIGURATIONS{{
+    {"tree --stream", {.engine = Engine::_tree, .streaming = true}},
+    {"tree --jit", {.engine = Engine::_tree, .jit = true}},
+    {"flat", {.engine = Engine::_flat}},
+    {"vm", {.engine = Engine::_vm, .cache = false}},
+    {"vm -O", {.engine = Engine::_vm, .optimize = true, .cache = false}},
+    {"closure", {.engine = Engine::_closure}},
+    {"closure -O", {.engine = Engine::_closure, .optimize = true}},
+}};
+
+constexpr std::array<std::string_view, 22> SCRIPTS{
+    "(1 + 2) * 3 - 4 / 8",
+    "-(2 * 3) + --1",
+    "1 / 0",
+    "-1 / 0",
+    "1 < 2 == 3 >= 4",
+    "\"a\" + \"b\" == \"ab\"",
+    "!nil == !!false",
+    "2 * (3 - -\"q\") + 1",
+    "\"a\" < 2",
+    "1 + (",
+
+    // x86 answers 0/0 with a negative NaN, negation flips it, and addsd/mulsd return the NaN of
+    // their first operand: whichever operand order an engine uses must not show.
+    "0 / 0",
+    "-(0 / 0)",
+    "(0 / 0) + -(0 / 0)",
+    "-(0 / 0) + (0 / 0)",
+    "(0 / 0) * -(0 / 0)",
+    "-(0 / 0) * (0 / 0)",
+    "(0 / 0) - -(0 / 0)",
+    "-(0 / 0) / (0 / 0)",
+    "1 + -(0 / 0) * 2",
+    "-(-(0 / 0) * 2)",
+    "0 / 0 == 0 / 0",
+    "-(0 / 0) != 0 / 0",
+};
+
+// More distinct names than a one byte slot operand can address. Names cannot hold digits, and
+// the prefix keeps them clear of keywords.
+std::string manyNames() {
+    std::string script{"xaa"};
+    for (int i{1}; i < 300; ++i) {
+        script += " + x";
+        script += static_cast<char>('a' + i / 26);
+        script += static_cast<char>('a' + i % 26);
+    }
+    return script;
+}
+
+std::string run(const Options& options, std::string_view script) {
+    std::ostringstream out{};
+    std::ostringstream err{};
+    Session session{options, out, err};
+    session.run(script);
+    std::print(out, "[{}]", session.exitStatus());
+    return out.str();
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> scripts{SCRIPTS.begin(), SCRIPTS.end()};
+    scripts.push_back(manyNames());
+
+    for (std::string_view script : scripts) {
+        std::string expected{run({.engine = Engine::_tree}, script)};
+        for (const Configuration& configuration : CONFIGURATIONS) {
+            std::string actual{run(configuration.options, script)};
+            if (!Check::check(actual == expected, configuration.name)) {
+                std::println(std::cerr, "  on '{}':\n{}\n  instead of:\n{}", script, actual,
+                             expected);
+            }
+        }
+    }
+    return Check::failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,116 @@
+#include "check.h"
+#include "lexer/lexer.h"
+#include "lexer/parallelLexer.h"
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/*
+ * ParallelLexer against Lexer: same tokens, same errors, in the same order. Chunks of a byte or
+ * two make every position a chunk boundary, inside strings and comments included.
+ */
+namespace {
+
+constexpr std::array<std::size_t, 3> THREADS{2, 3, 8};
+constexpr std::array<std::size_t, 3> MIN_CHUNK_BYTES{1, 2, 5};
+
+constexpr std::array<std::string_view, 14> SOURCES{
+    "",
+    "\n\n\n",
+    "(1 + 2.5) * 3\n- \"four\"\n>= nil and true\n",
+    "\"a\nb\nc\" + 1\n2\n",
+    "/* x\n y\n */ 1\n2\n",
+    "\"/*\"\n1\n\"*/\"\n",
+    "// \"\n1\n/* \" */ 2\n\"//\"\n",
+    "1 / 2 // comment\n3 /* / */ / 4\n",
+    "/**/\n\"\"\n/***/\n",
+    "1\n\"abc\ndef",
+    "1\n/* abc\n",
+    "1 @\n# 2\n3 $\n",
+    "12.\n.5\n1.2.3\n",
+    "\"unterminated\n/* never closed\n\"",
+};
+
+// Pieces that end strings and comments, or open them, at random places.
+constexpr std::array<std::string_view, 18> PIECES{
+    "\"", "/", "*", "\n", "\n", " ", "a", "1", "1.5", "+", "@", "/*", "*/", "//", "(", "\"x\ny\"",
+    "12.", "and",
+};
+
+struct Lexed {
+    TokenList tokens;
+    std::string out;
+    std::string err;
+    bool hadError;
+};
+
+Lexed lex(std::string_view source) {
+    std::ostringstream out{};
+    std::ostringstream err{};
+    Lexer lexer{source, out, err};
+    TokenList tokens{lexer.lexTokens()};
+    return {std::move(tokens), out.str(), err.str(), lexer.hadError()};
+}
+
+Lexed lex(std::string_view source, std::size_t threads, std::size_t minChunkBytes) {
+    std::ostringstream out{};
+    std::ostringstream err{};
+    ParallelLexer lexer{source, threads, out, err, minChunkBytes};
+    TokenList tokens{lexer.lexTokens()};
+    return {std::move(tokens), out.str(), err.str(), lexer.hadError()};
+}
+
+bool sameTokens(const TokenList& expected, const TokenList& actual) {
+    if (expected.size() != actual.size()) {
+        return false;
+    }
+    for (TokenList::Index i{0}; i < expected.size(); ++i) {
+        if (expected.type(i) != actual.type(i) || expected.lexeme(i) != actual.lexeme(i) ||
+            expected.literal(i) != actual.literal(i) || expected.line(i) != actual.line(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void checkSame(std::string_view source, std::size_t threads, std::size_t minChunkBytes) {
+    Lexed expected{lex(source)};
+    Lexed actual{lex(source, threads, minChunkBytes)};
+
+    bool same{Check::check(sameTokens(expected.tokens, actual.tokens), "same tokens") &&
+              Check::check(actual.out == expected.out, "same errors") &&
+              Check::check(actual.err == expected.err, "same diagnostics") &&
+              Check::check(actual.hadError == expected.hadError, "same error flag")};
+    if (!same) {
+        std::println(std::cerr, "  {} threads, chunks of {} bytes, on:\n{}", threads,
+                     minChunkBytes, source);
+    }
+}
+
+} // namespace
+
+int main() {
+    for (std::string_view source : SOURCES) {
+        for (std::size_t threads : THREADS) {
+            for (std::size_t minChunkBytes : MIN_CHUNK_BYTES) {
+                checkSame(source, threads, minChunkBytes);
+            }
+        }
+    }
+
+    std::mt19937 random{42};
+    for (int i{0}; i < 500 && Check::failures() == 0; ++i) {
+        std::string source{};
+        for (std::size_t length{random() % 80}; length > 0; --length) {
+            source += PIECES[random() % PIECES.size()];
+        }
+        checkSame(source, THREADS[random() % THREADS.size()],
+                  MIN_CHUNK_BYTES[random() % MIN_CHUNK_BYTES.size()]);
+    }
+    return Check::failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
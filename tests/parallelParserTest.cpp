@@ -0,0 +1,106 @@
+#include "check.h"
+#include "lexer/lexer.h"
+#include "parser/parallelParser.h"
+#include "parser/parser.h"
+#include "programPrinter.h"
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+/*
+ * ParallelParser against Parser::parseProgram(): same statements, same errors, in the same order.
+ * Slices of a token or three cut the program at nearly every ';'.
+ */
+namespace {
+
+constexpr std::array<std::size_t, 3> THREADS{2, 4, 16};
+constexpr std::array<std::size_t, 2> MIN_SLICE_TOKENS{1, 3};
+
+constexpr std::array<std::string_view, 10> SOURCES{
+    "",
+    "print 1;",
+    "print 1; 2 + 3; print \"a\" == nil; -4; !true;",
+    "print (1 + 2; 3; print 4;",
+    "print 1 2; print (; 3; 4 +;",
+    "1; 2; 3; print 4",
+    ";;;print 1;",
+    "(1; 2); print 3;",
+    "print 1; ) ; print 2; (;",
+    "print \"a\nb\"; 1 @ 2;\nprint x;",
+};
+
+// Statement pieces, broken ones included, with parentheses left open across ';'s.
+constexpr std::array<std::string_view, 21> PIECES{
+    "print ", "; ", ";\n", ";", "(", ")", "1 ", "2.5 ", "+ ", "- ", "* ", "!", "x ", "\"s\" ",
+    "var ", "{", "}", "== ", "print 1;\n", "1 + 2;\n", "(1;",
+};
+
+struct Parsed {
+    std::string program;
+    std::string out;
+    std::string err;
+    bool hadError;
+};
+
+std::string print(const std::optional<Statement::Program<std::string>>& program) {
+    return program.has_value() ? ProgramPrinter{}.print(*program) : "none";
+}
+
+Parsed parse(const TokenList& tokens) {
+    std::ostringstream out{};
+    std::ostringstream err{};
+    Parser<std::string> parser{tokens, out, err};
+    std::string program{print(parser.parseProgram())};
+    return {program, out.str(), err.str(), parser.hadError()};
+}
+
+Parsed parse(const TokenList& tokens, std::size_t threads, std::size_t minSliceTokens) {
+    std::ostringstream out{};
+    std::ostringstream err{};
+    ParallelParser<std::string> parser{tokens, threads, out, err, minSliceTokens};
+    std::string program{print(parser.parseProgram())};
+    return {program, out.str(), err.str(), parser.hadError()};
+}
+
+void checkSame(std::string_view source, std::size_t threads, std::size_t minSliceTokens) {
+    std::ostringstream lexerErrors{};
+    TokenList tokens{Lexer{source, lexerErrors, lexerErrors}.lexTokens()};
+    Parsed expected{parse(tokens)};
+    Parsed actual{parse(tokens, threads, minSliceTokens)};
+
+    bool same{Check::check(actual.program == expected.program, "same statements") &&
+              Check::check(actual.out == expected.out, "same errors") &&
+              Check::check(actual.err == expected.err, "same summary") &&
+              Check::check(actual.hadError == expected.hadError, "same error flag")};
+    if (!same) {
+        std::println(std::cerr, "  {} threads, slices of {} tokens, on:\n{}", threads,
+                     minSliceTokens, source);
+    }
+}
+
+} // namespace
+
+int main() {
+    for (std::string_view source : SOURCES) {
+        for (std::size_t threads : THREADS) {
+            for (std::size_t minSliceTokens : MIN_SLICE_TOKENS) {
+                checkSame(source, threads, minSliceTokens);
+            }
+        }
+    }
+
+    std::mt19937 random{7};
+    for (int i{0}; i < 500 && Check::failures() == 0; ++i) {
+        std::string source{};
+        for (std::size_t length{random() % 60}; length > 0; --length) {
+            source += PIECES[random() % PIECES.size()];
+        }
+        checkSame(source, THREADS[random() % THREADS.size()],
+                  MIN_SLICE_TOKENS[random() % MIN_SLICE_TOKENS.size()]);
+    }
+    return Check::failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
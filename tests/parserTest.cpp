@@ -0,0 +1,121 @@
+#include "check.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "programPrinter.h"
+#include <cstdlib>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+/*
+ * The statement grammar: program -> statement* EOF, statement -> ( "print" )? expression ";".
+ */
+namespace {
+
+struct Parsed {
+    // The printed program, nothing if parseProgram() gave none.
+    std::optional<std::string> program;
+    std::string out;
+    std::string err;
+    bool hadError;
+};
+
+Parsed parseProgram(std::string_view source) {
+    std::ostringstream out{};
+    std::ostringstream err{};
+    TokenList tokens{Lexer{source, out, err}.lexTokens()};
+    Parser<std::string> parser{tokens, out, err};
+    auto program{parser.parseProgram()};
+
+    Parsed parsed{std::nullopt, "", "", parser.hadError()};
+    if (program.has_value()) {
+        parsed.program = ProgramPrinter{}.print(*program);
+    }
+    parsed.out = out.str();
+    parsed.err = err.str();
+    return parsed;
+}
+
+void statements() {
+    Parsed parsed{parseProgram("print 1; 2 + 3;\nprint \"a\" == nil;")};
+    Check::check(parsed.program ==
+                     "print 1.000000\nexpression (+ 2.000000 3.000000)\nprint (== a nil)\n",
+                 "print and expression statements");
+    Check::check(!parsed.hadError && parsed.out.empty() && parsed.err.empty(), "no errors");
+
+    parsed = parseProgram("");
+    Check::check(parsed.program == "", "an empty program has no statements");
+    Check::check(!parsed.hadError, "an empty program is fine");
+
+    parsed = parseProgram("print (1 + 2) * -3;");
+    Check::check(parsed.program ==
+                     "print (* (group (+ 1.000000 2.000000)) (- 3.000000))\n",
+                 "print takes a whole expression");
+}
+
+void missingSemicolons() {
+    Parsed parsed{parseProgram("print 1")};
+    Check::check(!parsed.program.has_value() && parsed.hadError, "print needs its ';'");
+    Check::check(parsed.out == "[line 1] Error at end: Expect ';' after value.\n",
+                 "print error message");
+    Check::check(parsed.err ==
+                     "Parse error caught at top level parseProgram(): Expect ';' after value.\n",
+                 "print error summary");
+
+    parsed = parseProgram("1 + 2");
+    Check::check(!parsed.program.has_value(), "an expression statement needs its ';'");
+    Check::check(parsed.out == "[line 1] Error at end: Expect ';' after expression.\n",
+                 "expression statement error message");
+
+    parsed = parseProgram(";");
+    Check::check(!parsed.program.has_value(), "an empty statement is an error");
+    Check::check(parsed.out == "[line 1] Error at ';': Expected expression.\n",
+                 "empty statement error message");
+}
+
+// After an error the parser resumes after the next ';', so each statement reports its first error.
+void recovery() {
+    Parsed parsed{parseProgram("print 1 2;\nprint (;\n3;\n4 +;")};
+    Check::check(!parsed.program.has_value() && parsed.hadError, "errors leave no program");
+    Check::check(parsed.out == "[line 1] Error at '2': Expect ';' after value.\n"
+                               "[line 2] Error at ';': Expected expression.\n"
+                               "[line 4] Error at ';': Expected expression.\n",
+                 "one error per broken statement, none for the good one");
+    Check::check(parsed.err ==
+                     "Parse error caught at top level parseProgram(): Expect ';' after value.\n",
+                 "the summary names the first error");
+}
+
+void expressions() {
+    // parse() still reads a single expression, without a ';'.
+    std::ostringstream out{};
+    TokenList tokens{Lexer{"1 + 2 * 3", out, out}.lexTokens()};
+    Parser<std::string> parser{tokens, out, out};
+    auto expression{parser.parse()};
+    Check::check(expression != nullptr &&
+                     AstPrinter{}.print(*expression) == "(+ 1.000000 (* 2.000000 3.000000))",
+                 "parse() reads an expression");
+    Check::check(!parser.hadError() && out.str().empty(), "no errors");
+}
+
+void ranges() {
+    std::ostringstream out{};
+    TokenList tokens{Lexer{"print 1; 2; print 3;", out, out}.lexTokens()};
+    Parser<std::string> parser{tokens, out, out};
+    // Tokens 3 up to 6 are "2 ; print", a statement starting before the end is read whole.
+    auto program{parser.parseStatements(3, 6)};
+    Check::check(ProgramPrinter{}.print(program) == "expression 2.000000\nprint 3.000000\n",
+                 "parseStatements() reads the statements starting in its range");
+}
+
+} // namespace
+
+int main() {
+    statements();
+    missingSemicolons();
+    recovery();
+    expressions();
+    ranges();
+    return Check::failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,133 @@
+#include "check.h"
+#include "embed/preparedExpr.h"
+#include <array>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::array<std::string_view, 2> INPUTS{"price", "qty"};
+
+bool compiles(std::string_view source, std::string& diagnostics) {
+    std::ostringstream out{};
+    bool compiled{lox::compile(source, INPUTS, out).has_value()};
+    diagnostics = out.str();
+    return compiled;
+}
+
+void wholeExpression() {
+    std::string diagnostics{};
+    Check::check(!compiles("price > 1 and qty < 2", diagnostics),
+                 "'and' is not an operator, the rest must not be dropped");
+    Check::check(diagnostics.contains("Error at 'and': Expect end of expression."),
+                 "trailing 'and' is reported");
+
+    Check::check(!compiles("price qty", diagnostics), "two expressions in a row");
+    Check::check(diagnostics.contains("Error at 'qty': Expect end of expression."),
+                 "trailing name is reported");
+
+    Check::check(!compiles("(price) 1", diagnostics), "trailing literal");
+    Check::check(!compiles("price )", diagnostics), "trailing closer");
+
+    Check::check(compiles("price > 1 == qty < 2", diagnostics), "a whole expression compiles");
+    Check::check(diagnostics.empty(), "nothing is reported for a whole expression");
+}
+
+void evaluation() {
+    std::ostringstream diagnostics{};
+    auto rule{lox::compile("price * qty > 100", INPUTS, diagnostics)};
+    if (!Check::check(rule.has_value(), "rule compiles")) {
+        return;
+    }
+
+    std::array<Value, 2> cheap{Value{2.0}, Value{3.0}};
+    auto result{rule->evaluate(cheap)};
+    Check::check(result.has_value() && result->isBoolean() && !result->asBoolean(), "2 * 3");
+
+    std::array<Value, 2> dear{Value{20.0}, Value{30.0}};
+    result = rule->evaluate(dear);
+    Check::check(result.has_value() && result->isBoolean() && result->asBoolean(), "20 * 30");
+
+    std::array<Value, 2> wrong{Value{20.0}, Value{}};
+    Check::check(!rule->evaluate(wrong).has_value(), "nil operand is a runtime error");
+}
+
+// One handle, evaluated from several threads at once, each with its own inputs.
+void sharedHandle() {
+    std::ostringstream diagnostics{};
+    auto rule{lox::compile("price * qty > 100", INPUTS, diagnostics)};
+    if (!Check::check(rule.has_value(), "shared rule compiles")) {
+        return;
+    }
+
+    constexpr int THREADS{8};
+    constexpr int EVALUATIONS{10000};
+    std::array<int, THREADS> wrong{};
+    {
+        std::vector<std::jthread> threads{};
+        for (int t{0}; t < THREADS; ++t) {
+            threads.emplace_back([&rule, &wrong, t] {
+                for (int i{0}; i < EVALUATIONS; ++i) {
+                    double price{static_cast<double>(t)};
+                    double qty{static_cast<double>(i % 50)};
+                    std::array<Value, 2> inputs{Value{price}, Value{qty}};
+                    auto result{rule->evaluate(inputs)};
+                    if (!result.has_value() || !result->isBoolean() ||
+                        result->asBoolean() != (price * qty > 100)) {
+                        ++wrong[t];
+                    }
+                }
+            });
+        }
+    }
+
+    for (int t{0}; t < THREADS; ++t) {
+        Check::check(wrong[t] == 0, "every result on every thread");
+    }
+}
+
+// Past slot 255 inputs take the long operand. Names cannot hold digits, and the prefix keeps
+// them clear of keywords.
+void manyInputs() {
+    std::vector<std::string> names{};
+    std::string source{"0"};
+    for (int i{0}; i < 300; ++i) {
+        names.push_back({'x', static_cast<char>('a' + i / 26), static_cast<char>('a' + i % 26)});
+        source += " + ";
+        source += names.back();
+    }
+    std::vector<std::string_view> inputNames{names.begin(), names.end()};
+
+    std::ostringstream diagnostics{};
+    auto sum{lox::compile(source, inputNames, diagnostics)};
+    if (!Check::check(sum.has_value(), "300 inputs compile")) {
+        return;
+    }
+
+    std::vector<Value> inputs{};
+    for (int i{0}; i < 300; ++i) {
+        inputs.emplace_back(static_cast<double>(i));
+    }
+    auto result{sum->evaluate(inputs)};
+    Check::check(result.has_value() && result->isNumber() && result->asNumber() == 44850.0,
+                 "sum of 300 inputs");
+
+    inputs.pop_back();
+    result = sum->evaluate(inputs);
+    Check::check(!result.has_value() && std::string{result.error().what()}.contains("'xln'"),
+                 "unbound long slot is a runtime error");
+}
+
+} // namespace
+
+int main() {
+    wholeExpression();
+    evaluation();
+    sharedHandle();
+    manyInputs();
+    return Check::failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,44 @@
+#ifndef PROGRAM_PRINTER_H
+#define PROGRAM_PRINTER_H
+
+#include "ast/astPrinter.h"
+#include "ast/statementTrees.h"
+#include <string>
+
+/*
+ * One line per statement, its expression printed by AstPrinter, so parsed programs can be compared
+ * as text.
+ */
+class ProgramPrinter : public Statement::Visitor<std::string> {
+  public:
+    ProgramPrinter() = default;
+
+    ProgramPrinter(const ProgramPrinter&) = delete;
+    ProgramPrinter& operator=(const ProgramPrinter&) = delete;
+
+    ProgramPrinter(ProgramPrinter&&) noexcept = delete;
+    ProgramPrinter& operator=(ProgramPrinter&&) = delete;
+
+    ~ProgramPrinter() = default;
+
+    std::string print(const Statement::Program<std::string>& program) const {
+        std::string text{};
+        for (const auto& statement : program) {
+            text += statement->accept(*this);
+            text += '\n';
+        }
+        return text;
+    }
+
+    std::string visit(const Statement::ExpressionStatement<std::string>& stmt) const override {
+        return "expression " + m_printer.print(stmt.expr());
+    }
+    std::string visit(const Statement::PrintStatement<std::string>& stmt) const override {
+        return "print " + m_printer.print(stmt.expr());
+    }
+
+  private:
+    AstPrinter m_printer;
+};
+
+#endif // PROGRAM_PRINTER_H
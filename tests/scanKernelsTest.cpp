@@ -0,0 +1,141 @@
+#include "check.h"
+#include "lexer/scan.h"
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Every vector kernel the CPU supports against the scalar one, primitive by primitive, from every
+ * starting offset of every buffer. Runs are sized to end on, just before and just after 16 and 32
+ * byte block edges, where the vector loops hand over to their scalar tails.
+ */
+namespace {
+
+constexpr std::array<std::size_t, 12> RUN_LENGTHS{0, 1, 15, 16, 17, 31, 32, 33, 47, 63, 64, 65};
+
+// before, then count times piece, then after.
+std::string run(std::string_view before, std::string_view piece, std::size_t count,
+                std::string_view after) {
+    std::string text{before};
+    for (std::size_t i{0}; i < count; ++i) {
+        text += piece;
+    }
+    text += after;
+    return text;
+}
+
+std::vector<std::string> adversarialBuffers() {
+    std::vector<std::string> buffers{"", "\n", "\"", "/", "*", "*/", "//", "/*"};
+    for (std::size_t length : RUN_LENGTHS) {
+        // Runs ending in a stop byte, and runs ending with the buffer.
+        for (std::string_view end : {"", "x", "\"", "/", "*/", "\n", "0", "@", "[", "`", "{"}) {
+            buffers.push_back(run("", " ", length, end));
+            buffers.push_back(run(length % 2 == 0 ? "" : "\t", " \n", length / 2, end));
+            buffers.push_back(run("", "\n", length, end));
+            buffers.push_back(run("", "a", length, end));
+            buffers.push_back(run(length % 2 == 0 ? "" : "_", "Zq", length / 2, end));
+            buffers.push_back(run("", "7", length, end));
+        }
+        // Unterminated strings and block comments, and stars that do not close anything.
+        buffers.push_back(run("\"", "a\n", length, ""));
+        buffers.push_back(run("/*", "*\n", length, ""));
+        buffers.push_back(run("/*", " ", length, "*"));
+        buffers.push_back(run("/*", "*", length, "/"));
+        // A line comment at the very end of the buffer.
+        buffers.push_back(run("", "1 + ", length / 4, "//"));
+        buffers.push_back(run("", "x", length, "// no newline"));
+        // Bytes outside ASCII next to the letter and digit ranges.
+        buffers.push_back(run("", "\xc1\xfa\x80/:", length / 5 + 1, ""));
+    }
+    return buffers;
+}
+
+std::string randomBuffer(std::mt19937& random) {
+    constexpr std::string_view BYTES{" \n\t\r\"/*azAZ09_@[`{\xc1\xff"};
+    std::string buffer(random() % 200, ' ');
+    for (char& byte : buffer) {
+        byte = random() % 4 == 0 ? static_cast<char>(random()) : BYTES[random() % BYTES.size()];
+    }
+    // Long runs of one byte, to cross block edges.
+    std::size_t runs{random() % 4};
+    for (std::size_t i{0}; i < runs && !buffer.empty(); ++i) {
+        std::size_t begin{random() % buffer.size()};
+        std::size_t end{std::min(buffer.size(), begin + random() % 70)};
+        char byte{BYTES[random() % BYTES.size()]};
+        for (std::size_t j{begin}; j < end; ++j) {
+            buffer[j] = byte;
+        }
+    }
+    return buffer;
+}
+
+void checkSame(const Scan::Kernels& kernels, std::string_view buffer) {
+    const Scan::Kernels& scalar{Scan::scalarKernels()};
+    const char* data{buffer.data()};
+    std::size_t size{buffer.size()};
+
+    for (std::size_t from{0}; from <= size; ++from) {
+        bool same{true};
+        int expectedLines{0};
+        int actualLines{0};
+
+        same = same && kernels.skipWhitespace(data, from, size, actualLines) ==
+                           scalar.skipWhitespace(data, from, size, expectedLines);
+        same = same && kernels.findStringEnd(data, from, size, actualLines) ==
+                           scalar.findStringEnd(data, from, size, expectedLines);
+        same = same && kernels.findBlockCommentEnd(data, from, size, actualLines) ==
+                           scalar.findBlockCommentEnd(data, from, size, expectedLines);
+        same = same && actualLines == expectedLines;
+        same = same &&
+               kernels.findLineEnd(data, from, size) == scalar.findLineEnd(data, from, size);
+        same = same && kernels.findQuoteOrSlash(data, from, size) ==
+                           scalar.findQuoteOrSlash(data, from, size);
+        same = same && kernels.skipAlpha(data, from, size) == scalar.skipAlpha(data, from, size);
+        same = same && kernels.skipDigits(data, from, size) == scalar.skipDigits(data, from, size);
+
+        if (!Check::check(same, kernels.name)) {
+            std::println(std::cerr, "  from {} of {} bytes: {:?}", from, size, buffer);
+            return;
+        }
+    }
+}
+
+// Also with the buffer moved off its allocator's alignment, so that it ends mid-block.
+void checkAligned(const Scan::Kernels& kernels, std::string_view buffer) {
+    for (std::size_t padding : {0, 1, 7, 16, 31}) {
+        std::string padded(padding, '#');
+        padded += buffer;
+        checkSame(kernels, std::string_view{padded}.substr(padding));
+    }
+}
+
+} // namespace
+
+int main() {
+    std::vector<const Scan::Kernels*> vectorKernels{};
+    for (const Scan::Kernels* kernels : {Scan::sse2Kernels(), Scan::avx2Kernels()}) {
+        if (kernels != nullptr) {
+            vectorKernels.push_back(kernels);
+        }
+    }
+    if (vectorKernels.empty()) {
+        std::println("No vector kernels on this CPU, nothing to compare.");
+    }
+
+    std::vector<std::string> buffers{adversarialBuffers()};
+    std::mt19937 random{6};
+    for (int i{0}; i < 300; ++i) {
+        buffers.push_back(randomBuffer(random));
+    }
+
+    for (const Scan::Kernels* kernels : vectorKernels) {
+        for (const std::string& buffer : buffers) {
+            checkAligned(*kernels, buffer);
+        }
+    }
+    return Check::failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,162 @@
+#ifndef STRING_OBJECT_H
+#define STRING_OBJECT_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+ * Heap object behind every Lox string. Reference counted so Values can stay trivially small while
+ * still having value semantics. The count is atomic because constants may be shared between
+ * threads.
+ *
+ * A string is either a leaf owning its characters, or a rope node that only references the two
+ * strings it was concatenated from. Rope nodes are flattened lazily the first time their characters
+ * are needed (printing, comparing), so a chain of N concatenations copies each byte once instead of
+ * N times. Flattening mutates the node, so a rope must not be read from several threads before it
+ * has been flattened once.
+ *
+ * Interned strings (see StringTable) are immortal leaves: there is only ever one object per
+ * content, so they compare by address, and their reference count is never touched.
+ */
+class StringObject {
+  public:
+    explicit StringObject(std::string chars) : m_length{chars.size()}, m_chars{std::move(chars)} {}
+
+    StringObject(const StringObject&) = delete;
+    StringObject& operator=(const StringObject&) = delete;
+
+    StringObject(StringObject&&) noexcept = delete;
+    StringObject& operator=(StringObject&&) = delete;
+
+    ~StringObject() {
+        releaseChildren();
+    }
+
+    /*
+     * Returns a new string with a reference count of one. Short results are copied straight away,
+     * building a rope node for them would cost more than it saves.
+     */
+    static StringObject* concatenate(StringObject* left, StringObject* right) {
+        if (left->m_length + right->m_length <= SHORT_STRING) {
+            return new StringObject{left->chars() + right->chars()};
+        }
+        return new StringObject{left, right};
+    }
+
+    const std::string& chars() const {
+        if (isRope()) {
+            flatten();
+        }
+        return m_chars;
+    }
+
+    std::size_t length() const {
+        return m_length;
+    }
+
+    bool isRope() const {
+        return m_left != nullptr;
+    }
+
+    bool isInterned() const {
+        return m_interned;
+    }
+
+    void retain() {
+        if (m_interned) {
+            return;
+        }
+        m_refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Returns true when the last reference was dropped.
+    bool release() {
+        if (m_interned) {
+            return false;
+        }
+        return m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+  private:
+    friend class StringTable;
+
+    static constexpr std::size_t SHORT_STRING{64};
+
+    struct Interned {};
+
+    StringObject(std::string chars, Interned)
+        : m_length{chars.size()}, m_interned{true}, m_chars{std::move(chars)} {}
+
+    StringObject(StringObject* left, StringObject* right)
+        : m_length{left->m_length + right->m_length}, m_left{left}, m_right{right} {
+        left->retain();
+        right->retain();
+    }
+
+    /*
+     * Walks the rope left to right with an explicit stack, ropes built in a loop are as deep as
+     * the loop is long.
+     */
+    void flatten() const {
+        std::string flat{};
+        flat.reserve(m_length);
+
+        std::vector<const StringObject*> pending{this};
+        while (!pending.empty()) {
+            const StringObject* node{pending.back()};
+            pending.pop_back();
+
+            if (node->isRope()) {
+                pending.push_back(node->m_right);
+                pending.push_back(node->m_left);
+            } else {
+                flat += node->m_chars;
+            }
+        }
+
+        m_chars = std::move(flat);
+        releaseChildren();
+    }
+
+    /*
+     * Drops the references to both halves of a rope. Also iterative, so destroying a deep rope
+     * cannot overflow the stack.
+     */
+    void releaseChildren() const {
+        std::vector<StringObject*> dropped{};
+        auto drop{[&dropped](StringObject*& child) {
+            if (child != nullptr && child->release()) {
+                dropped.push_back(child);
+            }
+            child = nullptr;
+        }};
+
+        drop(m_left);
+        drop(m_right);
+
+        while (!dropped.empty()) {
+            StringObject* node{dropped.back()};
+            dropped.pop_back();
+
+            // Detach the children first so the destructor below has nothing left to do.
+            drop(node->m_left);
+            drop(node->m_right);
+            delete node;
+        }
+    }
+
+    std::atomic<std::uint32_t> m_refCount{1};
+    std::size_t m_length;
+    bool m_interned{false};
+    mutable StringObject* m_left{nullptr};
+    mutable StringObject* m_right{nullptr};
+    mutable std::string m_chars;
+};
+
+#endif // STRING_OBJECT_H
@@ -0,0 +1,66 @@
+#ifndef STRING_TABLE_H
+#define STRING_TABLE_H
+
+#include "stringObject.h"
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/*
+ * Process wide table of interned strings, one immortal StringObject per distinct content. Entries
+ * are never removed, so the table only grows with the number of distinct strings ever interned
+ * (literals, in practice), not with how often they appear.
+ *
+ * Lookups take a shared lock and inserts an exclusive one, so lexers on several threads interning
+ * the same keys mostly only read.
+ */
+class StringTable {
+  public:
+    static StringTable& global() {
+        static StringTable table{};
+        return table;
+    }
+
+    StringTable(const StringTable&) = delete;
+    StringTable& operator=(const StringTable&) = delete;
+
+    StringTable(StringTable&&) noexcept = delete;
+    StringTable& operator=(StringTable&&) = delete;
+
+    StringObject* intern(std::string_view chars) {
+        {
+            std::shared_lock lock{m_mutex};
+            if (auto found{m_strings.find(chars)}; found != m_strings.end()) {
+                return found->second;
+            }
+        }
+
+        std::unique_lock lock{m_mutex};
+        // Another thread may have inserted it between the two locks.
+        if (auto found{m_strings.find(chars)}; found != m_strings.end()) {
+            return found->second;
+        }
+
+        auto object{new StringObject{std::string{chars}, StringObject::Interned{}}};
+        // The key views the object's own characters, which never move or change.
+        m_strings.emplace(object->chars(), object);
+        return object;
+    }
+
+    std::size_t size() {
+        std::shared_lock lock{m_mutex};
+        return m_strings.size();
+    }
+
+  private:
+    StringTable() = default;
+    // Interned objects are immortal, the table never deletes them.
+    ~StringTable() = default;
+
+    std::shared_mutex m_mutex;
+    std::unordered_map<std::string_view, StringObject*> m_strings;
+};
+
+#endif // STRING_TABLE_H
@@ -3,20 +3,22 @@
 
 #include "tokentypes.h"
 #include "types.h"
-#include <string>
+#include <string_view>
+#include <utility>
 
 class Token {
   private:
     TokenType m_type{};
-    std::string m_lexeme;
-    Type m_literal;
-    [[maybe_unused]] int m_line;
+    std::string_view m_lexeme; // borrowed from the source buffer
+    Value m_literal;
+    [[maybe_unused]] int m_line{0};
 
   public:
-    Token(TokenType type, std::string_view lexeme, Type literal, int line)
-        : m_type{type}, m_lexeme(lexeme), m_literal{literal}, m_line{line} {}
+    Token() = default;
+    Token(TokenType type, std::string_view lexeme, Value literal, int line)
+        : m_type{type}, m_lexeme(lexeme), m_literal{std::move(literal)}, m_line{line} {}
 
-    std::string getLexeme() const {
+    std::string_view getLexeme() const {
         return m_lexeme;
     }
 
@@ -24,7 +26,7 @@ class Token {
         return m_type;
     }
 
-    Type getLiteral() const {
+    const Value& getLiteral() const {
         return m_literal;
     }
 
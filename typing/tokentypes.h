@@ -1,9 +1,10 @@
 #ifndef TOKEN_TYPES_H
 #define TOKEN_TYPES_H
 
+#include <cstdint>
 #include <iostream>
 
-enum class TokenType {
+enum class TokenType : std::uint8_t {
     _invalid_token,
 
     // Single character tokens
@@ -178,6 +179,9 @@ inline std::ostream& operator<<(std::ostream& out, const TokenType& token) {
     case _while:
         out << "while";
         break;
+    case _for:
+        out << "for";
+        break;
     case _var:
         out << "var";
         break;
@@ -0,0 +1,221 @@
+#ifndef VALUE_H
+#define VALUE_H
+
+#include "stringObject.h"
+#include "stringTable.h"
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace Jit {
+class Compiler;
+}
+
+/*
+ * A Lox value packed into 8 bytes with NaN-boxing.
+ *
+ * Any double but NaN is stored as is, every NaN as one canonical quiet NaN. Nil and the booleans
+ * are quiet NaNs with a small tag in the low bits, and strings are quiet NaNs with the sign bit set
+ * and a StringObject pointer in the low 48 bits.
+ */
+class Value {
+  public:
+    Value() = default; // nil
+    Value(bool boolean) : m_bits{boolean ? TRUE_VALUE : FALSE_VALUE} {}
+    Value(double number) : m_bits{std::bit_cast<std::uint64_t>(number)} {
+        // Every NaN becomes the canonical one, so no arithmetic result can ever be mistaken for a
+        // tagged value. Nor does the sign printed depend on which operand's NaN an engine's
+        // instructions happen to return.
+        if (number != number) {
+            m_bits = CANONICAL_NAN;
+        }
+    }
+    Value(std::string chars) : Value{new StringObject{std::move(chars)}} {}
+    Value(std::string_view chars) : Value{std::string{chars}} {}
+    Value(const char* chars) : Value{std::string{chars}} {}
+
+    /*
+     * The shared copy of a string, see StringTable. Used for literals, which are compared and
+     * repeated far more often than strings computed at runtime.
+     */
+    static Value intern(std::string_view chars) {
+        return Value{StringTable::global().intern(chars)};
+    }
+
+    /*
+     * Lox string concatenation. Builds a rope instead of copying both operands, see StringObject.
+     */
+    static Value concatenate(const Value& left, const Value& right) {
+        assert(left.isString() && right.isString() && "Can only concatenate strings.");
+        return Value{StringObject::concatenate(left.asObject(), right.asObject())};
+    }
+
+    Value(const Value& other) : m_bits{other.m_bits} {
+        if (isString()) {
+            asObject()->retain();
+        }
+    }
+    Value& operator=(const Value& other) {
+        Value copy{other};
+        std::swap(m_bits, copy.m_bits);
+        return *this;
+    }
+
+    Value(Value&& other) noexcept : m_bits{std::exchange(other.m_bits, NIL_VALUE)} {}
+    Value& operator=(Value&& other) noexcept {
+        std::swap(m_bits, other.m_bits);
+        return *this;
+    }
+
+    ~Value() {
+        if (isString() && asObject()->release()) {
+            delete asObject();
+        }
+    }
+
+    bool isNil() const {
+        return m_bits == NIL_VALUE;
+    }
+    bool isBoolean() const {
+        return (m_bits | 1) == TRUE_VALUE;
+    }
+    bool isNumber() const {
+        return (m_bits & QNAN) != QNAN;
+    }
+    bool isString() const {
+        return (m_bits & (QNAN | SIGN_BIT)) == (QNAN | SIGN_BIT);
+    }
+
+    bool asBoolean() const {
+        assert(isBoolean() && "Value is not a boolean.");
+        return m_bits == TRUE_VALUE;
+    }
+    double asNumber() const {
+        assert(isNumber() && "Value is not a number.");
+        return std::bit_cast<double>(m_bits);
+    }
+    const std::string& asString() const {
+        assert(isString() && "Value is not a string.");
+        return asObject()->chars();
+    }
+
+    // Lox truthiness: nil and false are falsey, everything else is truthy.
+    bool isTruthy() const {
+        return !isNil() && m_bits != FALSE_VALUE;
+    }
+
+    friend bool operator==(const Value& left, const Value& right) {
+        if (left.isNumber() && right.isNumber()) {
+            return left.asNumber() == right.asNumber();
+        }
+        if (left.isString() && right.isString()) {
+            const StringObject* a{left.asObject()};
+            const StringObject* b{right.asObject()};
+            if (a == b) {
+                return true;
+            }
+            // Two distinct interned objects always hold different strings.
+            if (a->isInterned() && b->isInterned()) {
+                return false;
+            }
+            // Cheap rejection before a rope has to be flattened.
+            return a->length() == b->length() && left.asString() == right.asString();
+        }
+        return left.m_bits == right.m_bits;
+    }
+
+    /*
+     * Ordering across types: nil is less than everything, then booleans < numbers < strings.
+     * Values of the same type compare naturally, so NaN is unordered.
+     */
+    friend bool operator<(const Value& left, const Value& right) {
+        if (right.isNil()) {
+            return false;
+        }
+        if (left.isNil()) {
+            return true;
+        }
+        if (left.rank() != right.rank()) {
+            return left.rank() < right.rank();
+        }
+        if (left.isNumber()) {
+            return left.asNumber() < right.asNumber();
+        }
+        if (left.isString()) {
+            return left.asString() < right.asString();
+        }
+        return left.asBoolean() < right.asBoolean();
+    }
+    friend bool operator>(const Value& left, const Value& right) {
+        return right < left;
+    }
+    friend bool operator<=(const Value& left, const Value& right) {
+        if (left.isNil()) {
+            return true;
+        }
+        if (right.isNil()) {
+            return false;
+        }
+        if (left.rank() != right.rank()) {
+            return left.rank() < right.rank();
+        }
+        if (left.isNumber()) {
+            return left.asNumber() <= right.asNumber();
+        }
+        if (left.isString()) {
+            return left.asString() <= right.asString();
+        }
+        return left.asBoolean() <= right.asBoolean();
+    }
+    friend bool operator>=(const Value& left, const Value& right) {
+        return right <= left;
+    }
+
+  private:
+    // Generates code that checks for numbers on the raw bits, see QNAN.
+    friend class Jit::Compiler;
+
+    static constexpr std::uint64_t SIGN_BIT{0x8000000000000000};
+    static constexpr std::uint64_t QNAN{0x7ffc000000000000};
+    static constexpr std::uint64_t CANONICAL_NAN{0x7ff8000000000000};
+
+    static constexpr std::uint64_t NIL_VALUE{QNAN | 1};
+    static constexpr std::uint64_t FALSE_VALUE{QNAN | 2};
+    static constexpr std::uint64_t TRUE_VALUE{QNAN | 3};
+
+    explicit Value(StringObject* object)
+        : m_bits{SIGN_BIT | QNAN | reinterpret_cast<std::uintptr_t>(object)} {}
+
+    StringObject* asObject() const {
+        return reinterpret_cast<StringObject*>(
+            static_cast<std::uintptr_t>(m_bits & ~(SIGN_BIT | QNAN)));
+    }
+
+    int rank() const {
+        return isBoolean() ? 0 : isNumber() ? 1 : 2;
+    }
+
+    std::uint64_t m_bits{NIL_VALUE};
+};
+
+static_assert(sizeof(Value) == 8, "Value must stay NaN-boxed.");
+
+inline std::ostream& operator<<(std::ostream& out, const Value& value) {
+    if (value.isNil()) {
+        out << "Nil";
+    } else if (value.isBoolean()) {
+        out << value.asBoolean();
+    } else if (value.isNumber()) {
+        // TODO: note that if its a double, then we may need to set precision here
+        out << value.asNumber();
+    } else {
+        out << value.asString();
+    }
+    return out;
+}
+
+#endif // VALUE_H
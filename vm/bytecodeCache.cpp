@@ -0,0 +1,145 @@
+#include "bytecodeCache.h"
+#include "source/sourceBuffer.h"
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::array<char, 4> MAGIC{'L', 'O', 'X', 'C'};
+
+// Bump whenever Header or what follows it changes, independently of BYTECODE_VERSION.
+constexpr std::uint32_t ENTRY_LAYOUT{2};
+
+// Stored in front of the source, which is followed by the serialized chunk.
+struct Header {
+    std::array<char, 4> magic;
+    std::uint32_t version;
+    std::uint32_t layout;
+    std::uint32_t foldedNodes;
+    std::uint64_t sourceHash;
+    std::uint64_t sourceSize;
+};
+
+std::filesystem::path defaultDirectory() {
+    if (const char* dir{std::getenv("LOX_CACHE_DIR")}; dir != nullptr && *dir != '\0') {
+        return dir;
+    }
+    if (const char* dir{std::getenv("XDG_CACHE_HOME")}; dir != nullptr && *dir != '\0') {
+        return std::filesystem::path{dir} / "lox";
+    }
+    if (const char* home{std::getenv("HOME")}; home != nullptr && *home != '\0') {
+        return std::filesystem::path{home} / ".cache" / "lox";
+    }
+    return {};
+}
+
+} // namespace
+
+BytecodeCache& BytecodeCache::global() {
+    static BytecodeCache cache{defaultDirectory()};
+    return cache;
+}
+
+BytecodeCache::BytecodeCache(std::filesystem::path directory) : m_directory{std::move(directory)} {}
+
+std::uint64_t BytecodeCache::hash(std::string_view bytes) {
+    std::uint64_t hash{0xcbf29ce484222325};
+    for (char c : bytes) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+auto BytecodeCache::load(std::string_view source, bool optimized) -> std::optional<Entry> {
+    if (m_directory.empty()) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    std::uint64_t sourceHash{hash(source)};
+    std::optional<Entry> cached{};
+
+    try {
+        SourceBuffer file{SourceBuffer::fromFile(entry(sourceHash, optimized).string())};
+        std::string_view bytes{file.view()};
+
+        Header header{};
+        if (bytes.size() >= sizeof(Header)) {
+            std::memcpy(&header, bytes.data(), sizeof(Header));
+            bytes.remove_prefix(sizeof(Header));
+            if (header.magic == MAGIC && header.version == BYTECODE_VERSION &&
+                header.layout == ENTRY_LAYOUT && header.sourceHash == sourceHash &&
+                header.sourceSize == source.size() && bytes.starts_with(source)) {
+                if (auto chunk{Chunk::deserialize(bytes.substr(source.size()))}) {
+                    cached = Entry{std::move(*chunk), header.foldedNodes};
+                }
+            }
+        }
+    } catch (const std::system_error&) {
+        // No entry yet.
+    }
+
+    (cached.has_value() ? m_hits : m_misses).fetch_add(1, std::memory_order_relaxed);
+    return cached;
+}
+
+void BytecodeCache::store(std::string_view source, bool optimized, const Chunk& chunk,
+                          std::uint32_t foldedNodes) {
+    if (m_directory.empty()) {
+        return;
+    }
+
+    std::uint64_t sourceHash{hash(source)};
+    Header header{MAGIC, BYTECODE_VERSION, ENTRY_LAYOUT, foldedNodes, sourceHash, source.size()};
+
+    std::string bytes(sizeof(Header), '\0');
+    std::memcpy(bytes.data(), &header, sizeof(Header));
+    bytes += source;
+    chunk.serialize(bytes);
+
+    std::error_code error{};
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        return;
+    }
+
+    // Unique per thread, so neither other threads nor other processes can collide with it.
+    std::filesystem::path target{entry(sourceHash, optimized)};
+    std::filesystem::path temporary{target};
+    // Piece by piece: GCC 12 warns about the temporaries of one long concatenation (-Wrestrict).
+    temporary += ".";
+    temporary += std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    temporary += ".";
+    temporary += std::to_string(::getpid());
+    temporary += ".tmp";
+
+    {
+        std::ofstream out{temporary, std::ios::binary | std::ios::trunc};
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!out) {
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporary, target, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+std::filesystem::path BytecodeCache::entry(std::uint64_t sourceHash, bool optimized) const {
+    std::array<char, 17> name{};
+    std::snprintf(name.data(), name.size(), "%016llx",
+                  static_cast<unsigned long long>(sourceHash));
+    return m_directory / (std::string{name.data()} + (optimized ? "-O" : "") + ".loxc");
+}
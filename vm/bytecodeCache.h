@@ -0,0 +1,67 @@
+#ifndef BYTECODE_CACHE_H
+#define BYTECODE_CACHE_H
+
+#include "chunk.h"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+/*
+ * Compiled chunks on disk, so scripts that have not changed since their last run skip lexing,
+ * parsing and compiling. Entries are named after a hash of the source (and of the options that
+ * change the bytecode), and are memory-mapped back in on later runs. Each entry keeps a copy of
+ * its source, which has to match byte for byte: the hash only picks the file.
+ *
+ * The cache is best effort: unreadable, stale or corrupt entries count as misses and are
+ * overwritten, failures to write are ignored. Entries are written to a temporary file and renamed
+ * into place, so concurrent runs never see half a file.
+ */
+class BytecodeCache {
+  public:
+    /*
+     * Shared by the whole process. Lives in $LOX_CACHE_DIR, else $XDG_CACHE_HOME/lox, else
+     * $HOME/.cache/lox; with none of these set every lookup is a miss.
+     */
+    static BytecodeCache& global();
+
+    explicit BytecodeCache(std::filesystem::path directory);
+
+    BytecodeCache(const BytecodeCache&) = delete;
+    BytecodeCache& operator=(const BytecodeCache&) = delete;
+
+    BytecodeCache(BytecodeCache&&) noexcept = delete;
+    BytecodeCache& operator=(BytecodeCache&&) = delete;
+
+    ~BytecodeCache() = default;
+
+    struct Entry {
+        Chunk chunk;
+        // What the constant folder reported when the chunk was compiled, 0 if it did not run.
+        std::uint32_t foldedNodes{0};
+    };
+
+    std::optional<Entry> load(std::string_view source, bool optimized);
+    void store(std::string_view source, bool optimized, const Chunk& chunk,
+               std::uint32_t foldedNodes);
+
+    std::uint64_t hits() const {
+        return m_hits.load(std::memory_order_relaxed);
+    }
+    std::uint64_t misses() const {
+        return m_misses.load(std::memory_order_relaxed);
+    }
+
+    // 64-bit FNV-1a.
+    static std::uint64_t hash(std::string_view bytes);
+
+  private:
+    std::filesystem::path entry(std::uint64_t sourceHash, bool optimized) const;
+
+    std::filesystem::path m_directory;
+    std::atomic<std::uint64_t> m_hits{0};
+    std::atomic<std::uint64_t> m_misses{0};
+};
+
+#endif // BYTECODE_CACHE_H
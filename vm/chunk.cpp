@@ -0,0 +1,252 @@
+#include "chunk.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+void Chunk::write(std::uint8_t byte, int line) {
+    // Only record a new entry when the line changes, most expressions sit on a single line.
+    if (m_lines.empty() || m_lines.back().line != line) {
+        m_lines.push_back({m_code.size(), line});
+    }
+    m_code.push_back(byte);
+}
+
+void Chunk::write(OpCode op, int line) {
+    write(static_cast<std::uint8_t>(op), line);
+}
+
+std::size_t Chunk::addConstant(Value value) {
+    m_constants.push_back(value);
+    return m_constants.size() - 1;
+}
+
+std::size_t Chunk::addInput(std::string_view name) {
+    auto input{std::find(m_inputs.begin(), m_inputs.end(), name)};
+    if (input != m_inputs.end()) {
+        return static_cast<std::size_t>(input - m_inputs.begin());
+    }
+    m_inputs.emplace_back(name);
+    return m_inputs.size() - 1;
+}
+
+int Chunk::getLine(std::size_t offset) const {
+    assert(!m_lines.empty() && "Line table is empty.");
+
+    // Find the last run starting at or before the offset.
+    auto run{std::upper_bound(m_lines.begin(), m_lines.end(), offset,
+                              [](std::size_t off, const LineStart& start) {
+                                  return off < start.offset;
+                              })};
+    return std::prev(run)->line;
+}
+
+namespace {
+
+enum class ConstantTag : std::uint8_t {
+    _number,
+    _string,
+};
+
+template <typename T>
+void put(std::string& out, T value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Reads from the front of `bytes`, failing instead of reading past the end.
+template <typename T>
+bool take(std::string_view& bytes, T& value) {
+    if (bytes.size() < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, bytes.data(), sizeof(T));
+    bytes.remove_prefix(sizeof(T));
+    return true;
+}
+
+} // namespace
+
+/*
+ * Layout: code size and bytes, line run count and runs (offset, line), constant count and
+ * constants (tag, then the number or the length and characters of the string), input count and
+ * names (length and characters).
+ */
+void Chunk::serialize(std::string& out) const {
+    put(out, static_cast<std::uint32_t>(m_code.size()));
+    out.append(reinterpret_cast<const char*>(m_code.data()), m_code.size());
+
+    put(out, static_cast<std::uint32_t>(m_lines.size()));
+    for (const auto& start : m_lines) {
+        put(out, static_cast<std::uint32_t>(start.offset));
+        put(out, static_cast<std::int32_t>(start.line));
+    }
+
+    put(out, static_cast<std::uint32_t>(m_constants.size()));
+    for (const auto& constant : m_constants) {
+        if (constant.isNumber()) {
+            put(out, ConstantTag::_number);
+            put(out, constant.asNumber());
+        } else {
+            assert(constant.isString() && "Only numbers and strings live in the constant pool.");
+            const std::string& chars{constant.asString()};
+            put(out, ConstantTag::_string);
+            put(out, static_cast<std::uint32_t>(chars.size()));
+            out += chars;
+        }
+    }
+
+    put(out, static_cast<std::uint32_t>(m_inputs.size()));
+    for (const auto& name : m_inputs) {
+        put(out, static_cast<std::uint32_t>(name.size()));
+        out += name;
+    }
+}
+
+std::optional<Chunk> Chunk::deserialize(std::string_view bytes) {
+    Chunk chunk{};
+    std::uint32_t count{};
+
+    if (!take(bytes, count) || bytes.size() < count) {
+        return std::nullopt;
+    }
+    chunk.m_code.assign(bytes.begin(), bytes.begin() + count);
+    bytes.remove_prefix(count);
+
+    if (!take(bytes, count)) {
+        return std::nullopt;
+    }
+    for (std::uint32_t i{0}; i < count; ++i) {
+        std::uint32_t offset{};
+        std::int32_t line{};
+        if (!take(bytes, offset) || !take(bytes, line)) {
+            return std::nullopt;
+        }
+        chunk.m_lines.push_back({offset, line});
+    }
+
+    if (!take(bytes, count)) {
+        return std::nullopt;
+    }
+    for (std::uint32_t i{0}; i < count; ++i) {
+        ConstantTag tag{};
+        if (!take(bytes, tag)) {
+            return std::nullopt;
+        }
+
+        if (tag == ConstantTag::_number) {
+            double number{};
+            if (!take(bytes, number)) {
+                return std::nullopt;
+            }
+            chunk.m_constants.emplace_back(number);
+        } else if (tag == ConstantTag::_string) {
+            std::uint32_t length{};
+            if (!take(bytes, length) || bytes.size() < length) {
+                return std::nullopt;
+            }
+            // Constants only ever come from literals, which are interned when compiled too.
+            chunk.m_constants.push_back(Value::intern(bytes.substr(0, length)));
+            bytes.remove_prefix(length);
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    if (!take(bytes, count)) {
+        return std::nullopt;
+    }
+    for (std::uint32_t i{0}; i < count; ++i) {
+        std::uint32_t length{};
+        if (!take(bytes, length) || bytes.size() < length) {
+            return std::nullopt;
+        }
+        chunk.m_inputs.emplace_back(bytes.substr(0, length));
+        bytes.remove_prefix(length);
+    }
+
+    if (!bytes.empty() || !chunk.validate()) {
+        return std::nullopt;
+    }
+    return chunk;
+}
+
+// Checks everything the VM relies on without checking it again: known opcodes, operands and
+// constant and input indices within bounds, a stack that never underflows, a line for offset 0
+// and a single return at the very end.
+bool Chunk::validate() const {
+    if (m_code.empty() || m_lines.empty() || m_lines.front().offset != 0) {
+        return false;
+    }
+
+    std::size_t depth{0};
+    bool returned{false};
+    for (std::size_t offset{0}; offset < m_code.size();) {
+        auto op{static_cast<OpCode>(m_code[offset++])};
+
+        switch (op) {
+        case OpCode::_constant:
+        case OpCode::_constant_long:
+        case OpCode::_nil:
+        case OpCode::_true:
+        case OpCode::_false:
+        case OpCode::_input:
+        case OpCode::_input_long:
+            depth += 1;
+            break;
+        case OpCode::_negate:
+        case OpCode::_not:
+            if (depth < 1) {
+                return false;
+            }
+            break;
+        case OpCode::_return:
+            if (depth < 1 || offset != m_code.size()) {
+                return false;
+            }
+            returned = true;
+            break;
+        case OpCode::_add:
+        case OpCode::_subtract:
+        case OpCode::_multiply:
+        case OpCode::_divide:
+        case OpCode::_greater:
+        case OpCode::_greater_equal:
+        case OpCode::_less:
+        case OpCode::_less_equal:
+        case OpCode::_equal:
+        case OpCode::_not_equal:
+            if (depth < 2) {
+                return false;
+            }
+            depth -= 1;
+            break;
+        default:
+            return false;
+        }
+
+        if (op == OpCode::_constant) {
+            if (offset >= m_code.size() || m_code[offset] >= m_constants.size()) {
+                return false;
+            }
+            offset += 1;
+        } else if (op == OpCode::_input) {
+            if (offset >= m_code.size() || m_code[offset] >= m_inputs.size()) {
+                return false;
+            }
+            offset += 1;
+        } else if (op == OpCode::_constant_long || op == OpCode::_input_long) {
+            if (offset + 3 > m_code.size()) {
+                return false;
+            }
+            std::size_t index{static_cast<std::size_t>(m_code[offset]) |
+                              static_cast<std::size_t>(m_code[offset + 1]) << 8 |
+                              static_cast<std::size_t>(m_code[offset + 2]) << 16};
+            if (index >= (op == OpCode::_constant_long ? m_constants.size() : m_inputs.size())) {
+                return false;
+            }
+            offset += 3;
+        }
+    }
+    return returned;
+}
@@ -0,0 +1,99 @@
+#ifndef CHUNK_H
+#define CHUNK_H
+
+#include "typing/types.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class OpCode : std::uint8_t {
+    _constant,
+    _constant_long,
+    _nil,
+    _true,
+    _false,
+    _input,
+    _input_long,
+
+    _add,
+    _subtract,
+    _multiply,
+    _divide,
+    _negate,
+    _not,
+
+    _greater,
+    _greater_equal,
+    _less,
+    _less_equal,
+    _equal,
+    _not_equal,
+
+    _return,
+};
+
+// Bump whenever the opcodes or the serialized layout below change, stale caches are then ignored.
+inline constexpr std::uint32_t BYTECODE_VERSION{3};
+
+/*
+ * A compiled unit of bytecode: the instruction stream, its constant pool, the names of its inputs
+ * and a run-length encoded line table so runtime errors can still be reported against the source.
+ *
+ * _input pushes the value the caller bound to an input slot, _input_long does the same for slots
+ * past 255 with a 24-bit operand like _constant_long. Slots are numbered in the order
+ * names were added, so an embedder declares its inputs first and the compiler appends any other
+ * name it meets; those are left unbound and fail at runtime.
+ */
+class Chunk {
+  public:
+    Chunk() = default;
+
+    Chunk(const Chunk&) = delete;
+    Chunk& operator=(const Chunk&) = delete;
+
+    Chunk(Chunk&&) noexcept = default;
+    Chunk& operator=(Chunk&&) = default;
+
+    ~Chunk() = default;
+
+    void write(std::uint8_t byte, int line);
+    void write(OpCode op, int line);
+    std::size_t addConstant(Value value);
+    // The slot of `name`, added as the next one if it has none yet.
+    std::size_t addInput(std::string_view name);
+    int getLine(std::size_t offset) const;
+
+    const std::vector<std::uint8_t>& code() const {
+        return m_code;
+    }
+    const std::vector<Value>& constants() const {
+        return m_constants;
+    }
+    const std::vector<std::string>& inputs() const {
+        return m_inputs;
+    }
+
+    /*
+     * Binary form for the bytecode cache, in native byte order. deserialize() validates sizes,
+     * opcodes and constant indices, and returns nothing for anything it cannot trust.
+     */
+    void serialize(std::string& out) const;
+    static std::optional<Chunk> deserialize(std::string_view bytes);
+
+  private:
+    bool validate() const;
+
+    struct LineStart {
+        std::size_t offset;
+        int line;
+    };
+
+    std::vector<std::uint8_t> m_code;
+    std::vector<Value> m_constants;
+    std::vector<std::string> m_inputs;
+    std::vector<LineStart> m_lines;
+};
+
+#endif // CHUNK_H
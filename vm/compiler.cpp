@@ -0,0 +1,128 @@
+#include "compiler.h"
+#include "typing/tokentypes.h"
+#include <cstdint>
+#include <stdexcept>
+
+void Compiler::compile(const Expression::Expression<Value>& expr) const {
+    expr.accept(*this);
+    emit(OpCode::_return);
+}
+
+Value Compiler::visit(const Expression::Binary<Value>& expr) const {
+    expr.left().accept(*this);
+    expr.right().accept(*this);
+
+    m_line = expr.op().getLine();
+
+    switch (expr.op().getType()) {
+    case TokenType::_plus:
+        emit(OpCode::_add);
+        break;
+    case TokenType::_minus:
+        emit(OpCode::_subtract);
+        break;
+    case TokenType::_slash:
+        emit(OpCode::_divide);
+        break;
+    case TokenType::_star:
+        emit(OpCode::_multiply);
+        break;
+    case TokenType::_greater:
+        emit(OpCode::_greater);
+        break;
+    case TokenType::_greater_equal:
+        emit(OpCode::_greater_equal);
+        break;
+    case TokenType::_less:
+        emit(OpCode::_less);
+        break;
+    case TokenType::_less_equal:
+        emit(OpCode::_less_equal);
+        break;
+    case TokenType::_equal_equal:
+        emit(OpCode::_equal);
+        break;
+    case TokenType::_bang_equal:
+        emit(OpCode::_not_equal);
+        break;
+    default:
+        // The parser never produces any other binary operator.
+        throw std::logic_error{"Unknown binary operator."};
+    }
+
+    return Value{};
+}
+
+Value Compiler::visit(const Expression::Grouping<Value>& expr) const {
+    return expr.expr().accept(*this);
+}
+
+Value Compiler::visit(const Expression::Literal<Value>& expr) const {
+    Value literal{expr.getLiteral()};
+
+    if (literal.isNil()) {
+        emit(OpCode::_nil);
+    } else if (literal.isBoolean()) {
+        emit(literal.asBoolean() ? OpCode::_true : OpCode::_false);
+    } else {
+        emitConstant(literal);
+    }
+
+    return Value{};
+}
+
+Value Compiler::visit(const Expression::Unary<Value>& expr) const {
+    expr.right().accept(*this);
+
+    m_line = expr.op().getLine();
+
+    switch (expr.op().getType()) {
+    case TokenType::_minus:
+        emit(OpCode::_negate);
+        break;
+    case TokenType::_bang:
+        emit(OpCode::_not);
+        break;
+    default:
+        throw std::logic_error{"Unknown unary operator."};
+    }
+
+    return Value{};
+}
+
+Value Compiler::visit(const Expression::Variable<Value>& expr) const {
+    m_line = expr.name().getLine();
+
+    std::size_t slot{m_chunk.addInput(expr.name().getLexeme())};
+    if (slot > 0xffffff) {
+        throw std::length_error{"Too many inputs in one chunk."};
+    }
+    emitOperand(OpCode::_input, OpCode::_input_long, slot);
+
+    return Value{};
+}
+
+void Compiler::emit(OpCode op) const {
+    m_chunk.write(op, m_line);
+}
+
+void Compiler::emitConstant(Value value) const {
+    std::size_t index{m_chunk.addConstant(value)};
+    if (index > 0xffffff) {
+        throw std::length_error{"Too many constants in one chunk."};
+    }
+    emitOperand(OpCode::_constant, OpCode::_constant_long, index);
+}
+
+void Compiler::emitOperand(OpCode op, OpCode longOp, std::size_t index) const {
+    if (index <= UINT8_MAX) {
+        emit(op);
+        m_chunk.write(static_cast<std::uint8_t>(index), m_line);
+    } else {
+        // 24-bit operand, little endian.
+        emit(longOp);
+        m_chunk.write(static_cast<std::uint8_t>(index & 0xff), m_line);
+        m_chunk.write(static_cast<std::uint8_t>((index >> 8) & 0xff), m_line);
+        m_chunk.write(static_cast<std::uint8_t>((index >> 16) & 0xff), m_line);
+    }
+}
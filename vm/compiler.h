@@ -0,0 +1,44 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include "ast/expressionTrees.h"
+#include "chunk.h"
+#include "typing/types.h"
+#include <cstddef>
+
+/*
+ * Lowers an expression tree into a bytecode chunk for the VM. The visitor returns are unused, all
+ * output goes into the chunk.
+ */
+class Compiler : public Expression::Visitor<Value> {
+  public:
+    Compiler(Chunk& chunk) : m_chunk{chunk} {};
+
+    Compiler(const Compiler&) = delete;
+    Compiler& operator=(const Compiler&) = delete;
+
+    Compiler(Compiler&&) noexcept = delete;
+    Compiler& operator=(Compiler&&) = delete;
+
+    ~Compiler() = default;
+
+    void compile(const Expression::Expression<Value>& expr) const;
+
+    Value visit(const Expression::Binary<Value>& expr) const override;
+    Value visit(const Expression::Grouping<Value>& expr) const override;
+    Value visit(const Expression::Literal<Value>& expr) const override;
+    Value visit(const Expression::Unary<Value>& expr) const override;
+    Value visit(const Expression::Variable<Value>& expr) const override;
+
+  private:
+    void emit(OpCode op) const;
+    void emitConstant(Value value) const;
+    // The one byte form of op for indices up to 255, longOp with a 24-bit operand past that.
+    void emitOperand(OpCode op, OpCode longOp, std::size_t index) const;
+
+    Chunk& m_chunk;
+    // Literals carry no token, so they are attributed to the line of the last operator seen.
+    mutable int m_line{1};
+};
+
+#endif // COMPILER_H
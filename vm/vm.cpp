@@ -0,0 +1,213 @@
+#include "vm.h"
+#include "error/error.h"
+#include "typing/token.h"
+#include <exception>
+#include <print>
+
+void VM::interpret(const Chunk& chunk) {
+    try {
+        Value value{run(chunk)};
+
+        if (auto error{takeError()}) {
+            std::println(m_errorReporter.err(),
+                         "Lox runtime error caught at top level interpret(): {}", error->what());
+            m_errorReporter.runtimeError(*error);
+            return;
+        }
+        m_errorReporter.out() << value << '\n';
+    } catch (const std::exception& e) {
+        std::println(m_errorReporter.err(), "Unknown error caught at top level interpret(): {}",
+                     e.what());
+    }
+}
+
+Value VM::run(const Chunk& chunk, std::span<const Value> inputs) {
+    m_stack.clear();
+    m_error.reset();
+
+    const std::uint8_t* ip{chunk.code().data()};
+
+    while (true) {
+        switch (static_cast<OpCode>(*ip++)) {
+        case OpCode::_constant:
+            push(chunk.constants()[*ip++]);
+            break;
+
+        case OpCode::_constant_long: {
+            std::size_t index{static_cast<std::size_t>(ip[0]) |
+                              static_cast<std::size_t>(ip[1]) << 8 |
+                              static_cast<std::size_t>(ip[2]) << 16};
+            ip += 3;
+            push(chunk.constants()[index]);
+            break;
+        }
+
+        case OpCode::_nil:
+            push(Value{});
+            break;
+        case OpCode::_true:
+            push(true);
+            break;
+        case OpCode::_false:
+            push(false);
+            break;
+
+        case OpCode::_input: {
+            std::size_t slot{*ip++};
+            if (slot >= inputs.size()) {
+                return runtimeError(chunk, ip - 1, undefinedVariable(chunk.inputs()[slot]));
+            }
+            push(inputs[slot]);
+            break;
+        }
+
+        case OpCode::_input_long: {
+            std::size_t slot{static_cast<std::size_t>(ip[0]) |
+                             static_cast<std::size_t>(ip[1]) << 8 |
+                             static_cast<std::size_t>(ip[2]) << 16};
+            ip += 3;
+            if (slot >= inputs.size()) {
+                return runtimeError(chunk, ip - 1, undefinedVariable(chunk.inputs()[slot]));
+            }
+            push(inputs[slot]);
+            break;
+        }
+
+        case OpCode::_add: {
+            Value right{pop()};
+            Value left{pop()};
+            if (left.isNumber() && right.isNumber()) {
+                push(left.asNumber() + right.asNumber());
+            } else if (left.isString() && right.isString()) {
+                push(Value::concatenate(left, right));
+            } else {
+                return runtimeError(chunk, ip, "Operands must be two numbers or two strings.");
+            }
+            break;
+        }
+
+        case OpCode::_subtract: {
+            Value right{pop()};
+            Value left{pop()};
+            if (!checkNumberOperands(chunk, ip, left, right)) {
+                return Value{};
+            }
+            push(left.asNumber() - right.asNumber());
+            break;
+        }
+
+        case OpCode::_multiply: {
+            Value right{pop()};
+            Value left{pop()};
+            if (!checkNumberOperands(chunk, ip, left, right)) {
+                return Value{};
+            }
+            push(left.asNumber() * right.asNumber());
+            break;
+        }
+
+        case OpCode::_divide: {
+            Value right{pop()};
+            Value left{pop()};
+            if (!checkNumberOperands(chunk, ip, left, right)) {
+                return Value{};
+            }
+            push(left.asNumber() / right.asNumber());
+            break;
+        }
+
+        case OpCode::_negate: {
+            Value right{pop()};
+            if (!checkNumberOperand(chunk, ip, right)) {
+                return Value{};
+            }
+            push(-right.asNumber());
+            break;
+        }
+
+        case OpCode::_not: {
+            // Same as the tree-walker: nil and false are falsey, everything else is truthy.
+            Value right{pop()};
+            push(!right.isTruthy());
+            break;
+        }
+
+        // Same ordering rules as the tree-walker, see Interpreter::visit(Binary).
+        case OpCode::_greater: {
+            Value right{pop()};
+            Value left{pop()};
+            push(left > right);
+            break;
+        }
+        case OpCode::_greater_equal: {
+            Value right{pop()};
+            Value left{pop()};
+            push(left >= right);
+            break;
+        }
+        case OpCode::_less: {
+            Value right{pop()};
+            Value left{pop()};
+            push(left < right);
+            break;
+        }
+        case OpCode::_less_equal: {
+            Value right{pop()};
+            Value left{pop()};
+            push(left <= right);
+            break;
+        }
+        case OpCode::_equal: {
+            Value right{pop()};
+            Value left{pop()};
+            push(left == right);
+            break;
+        }
+        case OpCode::_not_equal: {
+            Value right{pop()};
+            Value left{pop()};
+            push(left != right);
+            break;
+        }
+
+        case OpCode::_return:
+            return pop();
+        }
+    }
+}
+
+void VM::push(Value value) {
+    m_stack.push_back(std::move(value));
+}
+
+Value VM::pop() {
+    Value value{std::move(m_stack.back())};
+    m_stack.pop_back();
+    return value;
+}
+
+bool VM::checkNumberOperand(const Chunk& chunk, const std::uint8_t* ip, const Value& operand) {
+    if (operand.isNumber()) {
+        return true;
+    }
+
+    runtimeError(chunk, ip, "Unary operand must be a number.");
+    return false;
+}
+
+bool VM::checkNumberOperands(const Chunk& chunk, const std::uint8_t* ip, const Value& left,
+                             const Value& right) {
+    if (left.isNumber() && right.isNumber()) {
+        return true;
+    }
+
+    runtimeError(chunk, ip, "Binary operand must be a number.");
+    return false;
+}
+
+Value VM::runtimeError(const Chunk& chunk, const std::uint8_t* ip, std::string_view message) {
+    // ip already points past the failing instruction.
+    std::size_t offset{static_cast<std::size_t>(ip - chunk.code().data() - 1)};
+    m_error.emplace(Token{TokenType::_invalid_token, "", Value{}, chunk.getLine(offset)}, message);
+    return Value{};
+}
@@ -0,0 +1,61 @@
+#ifndef VM_H
+#define VM_H
+
+#include "chunk.h"
+#include "error/error.h"
+#include "typing/types.h"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+ * Stack-based bytecode virtual machine. Runs chunks produced by the Compiler and is meant to give
+ * the same observable results as the tree-walking Interpreter.
+ */
+class VM {
+  public:
+    explicit VM(std::ostream& out = std::cout, std::ostream& err = std::cerr)
+        : m_errorReporter{"VM", out, err} {}
+
+    VM(const VM&) = delete;
+    VM& operator=(const VM&) = delete;
+
+    VM(VM&&) noexcept = delete;
+    VM& operator=(VM&&) = delete;
+
+    ~VM() = default;
+
+    void interpret(const Chunk& chunk);
+    // inputs[i] is bound to the chunk's input slot i, slots past the end are undefined.
+    Value run(const Chunk& chunk, std::span<const Value> inputs = {});
+
+    // The error that stopped the last run(), if any, leaving none pending.
+    std::optional<LoxRuntimeError> takeError() {
+        return std::exchange(m_error, std::nullopt);
+    }
+
+    bool hadError() const {
+        return m_errorReporter.hadError();
+    };
+    bool hadRuntimeError() const {
+        return m_errorReporter.hadRuntimeError();
+    };
+
+  private:
+    void push(Value value);
+    Value pop();
+    bool checkNumberOperand(const Chunk& chunk, const std::uint8_t* ip, const Value& operand);
+    bool checkNumberOperands(const Chunk& chunk, const std::uint8_t* ip, const Value& left,
+                             const Value& right);
+    // Records the error for interpret(), run() returns right after.
+    Value runtimeError(const Chunk& chunk, const std::uint8_t* ip, std::string_view message);
+
+    std::vector<Value> m_stack;
+    ErrorReporter m_errorReporter;
+    std::optional<LoxRuntimeError> m_error;
+};
+
+#endif // VM_H